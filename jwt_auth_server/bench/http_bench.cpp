@@ -0,0 +1,265 @@
+/**
+ * @file http_bench.cpp
+ * @brief Нагрузка на GET /secure/data: запросы в секунду и задержки для нескольких запущенных серверов.
+ *
+ * Для каждой цели бенчмарк регистрирует (или просто логинит) пользователя,
+ * получает access токен и в течение заданного времени держит N keep-alive
+ * соединений, каждое из которых шлёт запросы последовательно. Так одной
+ * командой сравниваются движки (httplib, epoll, io_uring), запущенные на разных портах.
+ *
+ * Access токен живёт минуту, поэтому длительность прогона ограничена 50 секундами.
+ *
+ * Запуск: `./http_bench [секунды] [соединений] имя=хост:порт...`
+ * Пример: `./http_bench 10 64 httplib=127.0.0.1:8080 epoll=127.0.0.1:8081 io_uring=127.0.0.1:8082`
+ */
+#include "../include/extern/httplib.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const char* BENCH_USER = "http_bench";
+    const char* BENCH_PASSWORD = "http_bench_password";
+
+    struct Target {
+        std::string name;
+        std::string host;
+        int port = 0;
+    };
+
+    /**
+     * @brief Итоги одного соединения.
+     */
+    struct WorkerResult {
+        std::vector<uint32_t> latenciesUs;
+        size_t errors = 0;
+        size_t reconnects = 0;
+    };
+
+    bool parseTarget(const std::string& arg, Target& out) {
+        size_t eq = arg.find('=');
+        std::string address = eq == std::string::npos ? arg : arg.substr(eq + 1);
+        size_t colon = address.rfind(':');
+        if (colon == std::string::npos) return false;
+        out.name = eq == std::string::npos ? address : arg.substr(0, eq);
+        out.host = address.substr(0, colon);
+        out.port = std::atoi(address.c_str() + colon + 1);
+        return out.port > 0;
+    }
+
+    /**
+     * @brief Регистрирует тестового пользователя (409 — уже есть) и возвращает access токен.
+     */
+    bool obtainToken(const Target& target, std::string& token) {
+        httplib::Client client(target.host, target.port);
+        client.set_read_timeout(30, 0);
+        std::string body = std::string("{\"username\":\"") + BENCH_USER + "\",\"password\":\"" + BENCH_PASSWORD + "\"}";
+
+        auto reg = client.Post("/register", body, "application/json");
+        if (!reg || (reg->status != 201 && reg->status != 409)) {
+            std::fprintf(stderr, "%s: /register не удался\n", target.name.c_str());
+            return false;
+        }
+        auto login = client.Post("/login", body, "application/json");
+        if (!login || login->status != 200) {
+            std::fprintf(stderr, "%s: /login не удался\n", target.name.c_str());
+            return false;
+        }
+
+        const std::string key = "\"access_token\":\"";
+        size_t start = login->body.find(key);
+        if (start == std::string::npos) return false;
+        start += key.size();
+        size_t end = login->body.find('"', start);
+        if (end == std::string::npos) return false;
+        token = login->body.substr(start, end - start);
+        return true;
+    }
+
+    int connectTo(const Target& target) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addr = nullptr;
+        std::string port = std::to_string(target.port);
+        if (::getaddrinfo(target.host.c_str(), port.c_str(), &hints, &addr) != 0 || !addr) return -1;
+
+        int fd = ::socket(addr->ai_family, SOCK_STREAM | SOCK_CLOEXEC, addr->ai_protocol);
+        if (fd >= 0 && ::connect(fd, addr->ai_addr, addr->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        ::freeaddrinfo(addr);
+        if (fd >= 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        return fd;
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Читает один ответ с Content-Length.
+     *
+     * @param buf Буфер соединения (в нём может остаться начало следующего ответа).
+     * @param[out] status Код ответа.
+     * @param[out] keepAlive Сервер оставляет соединение открытым.
+     */
+    bool readResponse(int fd, std::string& buf, int& status, bool& keepAlive) {
+        char chunk[16384];
+        size_t headerEnd;
+        while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buf.append(chunk, static_cast<size_t>(n));
+        }
+
+        std::string head = buf.substr(0, headerEnd);
+        if (head.compare(0, 9, "HTTP/1.1 ") != 0) return false;
+        status = std::atoi(head.c_str() + 9);
+
+        for (char& c : head) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        size_t lengthPos = head.find("\r\ncontent-length:");
+        size_t length = lengthPos == std::string::npos ? 0 : std::strtoul(head.c_str() + lengthPos + 17, nullptr, 10);
+        keepAlive = head.find("\r\nconnection: close") == std::string::npos;
+
+        size_t total = headerEnd + 4 + length;
+        while (buf.size() < total) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buf.append(chunk, static_cast<size_t>(n));
+        }
+        buf.erase(0, total);
+        return true;
+    }
+
+    void worker(const Target& target, const std::string& request, Clock::time_point deadline, WorkerResult& result) {
+        int fd = -1;
+        std::string buf;
+        result.latenciesUs.reserve(1 << 16);
+
+        while (Clock::now() < deadline) {
+            if (fd < 0) {
+                fd = connectTo(target);
+                if (fd < 0) {
+                    result.errors++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    continue;
+                }
+                buf.clear();
+            }
+
+            auto start = Clock::now();
+            int status = 0;
+            bool keepAlive = false;
+            if (!sendAll(fd, request) || !readResponse(fd, buf, status, keepAlive)) {
+                result.errors++;
+                ::close(fd);
+                fd = -1;
+                continue;
+            }
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+            result.latenciesUs.push_back(static_cast<uint32_t>(us));
+            if (status != 200) result.errors++;
+
+            // Сервер закрывает соединение после keep-alive-max запросов.
+            if (!keepAlive) {
+                ::close(fd);
+                fd = -1;
+                result.reconnects++;
+            }
+        }
+        if (fd >= 0) ::close(fd);
+    }
+
+    uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    void runTarget(const Target& target, int seconds, size_t connections) {
+        std::string token;
+        if (!obtainToken(target, token)) {
+            std::printf("%-10s недоступен\n", target.name.c_str());
+            return;
+        }
+
+        std::string request = "GET /secure/data HTTP/1.1\r\nHost: " + target.host +
+                              "\r\nAuthorization: Bearer " + token + "\r\n\r\n";
+
+        std::vector<WorkerResult> results(connections);
+        std::vector<std::thread> threads;
+        auto start = Clock::now();
+        auto deadline = start + std::chrono::seconds(seconds);
+        for (size_t i = 0; i < connections; ++i)
+            threads.emplace_back(worker, std::cref(target), std::cref(request), deadline, std::ref(results[i]));
+        for (auto& t : threads) t.join();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<uint32_t> all;
+        size_t errors = 0;
+        size_t reconnects = 0;
+        for (const WorkerResult& r : results) {
+            all.insert(all.end(), r.latenciesUs.begin(), r.latenciesUs.end());
+            errors += r.errors;
+            reconnects += r.reconnects;
+        }
+        std::sort(all.begin(), all.end());
+
+        std::printf("%-10s %10zu %12.0f %10u %10u %10u %8zu %10zu\n",
+                    target.name.c_str(), all.size(), elapsed > 0 ? all.size() / elapsed : 0.0,
+                    percentile(all, 0.50), percentile(all, 0.99), all.empty() ? 0 : all.back(),
+                    errors, reconnects);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::fprintf(stderr, "Запуск: %s секунды соединений имя=хост:порт...\n", argv[0]);
+        return 1;
+    }
+
+    int seconds = std::clamp(std::atoi(argv[1]), 1, 50);
+    size_t connections = static_cast<size_t>(std::clamp(std::atoi(argv[2]), 1, 4096));
+
+    std::vector<Target> targets;
+    for (int i = 3; i < argc; ++i) {
+        Target target;
+        if (!parseTarget(argv[i], target)) {
+            std::fprintf(stderr, "Неверная цель: %s\n", argv[i]);
+            return 1;
+        }
+        targets.push_back(target);
+    }
+
+    std::printf("GET /secure/data, %d с, %zu keep-alive соединений\n", seconds, connections);
+    std::printf("%-10s %10s %12s %10s %10s %10s %8s %10s\n",
+                "engine", "requests", "req/s", "p50 us", "p99 us", "max us", "errors", "reconnects");
+    for (const Target& target : targets) runTarget(target, seconds, connections);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file json_bench.cpp
+ * @brief Сравнение извлечения полей: многопроходный поиск через find() против Json::parseObject().
+ *
+ * Измеряются два типичных сценария:
+ * - тело `/login` (`username`, `password`);
+ * - payload токена (`sub`, `iat`, `exp`, `typ`).
+ *
+ * Запуск: `./json_bench [итераций]`
+ */
+#include "../include/Json.h"
+#include "../include/JWT.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void report(const char* phase, size_t ops, double seconds) {
+        std::printf("%-32s %10zu ops %10.3f s %12.0f ops/s %8.1f ns/op\n",
+                    phase, ops, seconds, seconds > 0 ? ops / seconds : 0.0,
+                    ops > 0 ? seconds * 1e9 / ops : 0.0);
+    }
+
+    // Прежний разбор тела запроса из HttpServer.cpp.
+    std::string legacyExtractField(const std::string& json, const std::string& key) {
+        std::string pattern = "\"" + key + "\"";
+        size_t key_pos = json.find(pattern);
+        if (key_pos == std::string::npos) return "";
+        size_t colon_pos = json.find(':', key_pos);
+        if (colon_pos == std::string::npos) return "";
+        size_t quote_start = json.find('"', colon_pos + 1);
+        if (quote_start == std::string::npos) return "";
+        size_t quote_end = json.find('"', quote_start + 1);
+        if (quote_end == std::string::npos) return "";
+        return json.substr(quote_start + 1, quote_end - quote_start - 1);
+    }
+
+    // Прежний разбор claims из JWT.cpp.
+    bool legacyClaims(const std::string& payloadJson, std::string& sub, uint64_t& exp) {
+        if (payloadJson.find("\"typ\":\"access\"") == std::string::npos) return false;
+        size_t subPos = payloadJson.find("\"sub\":\"");
+        size_t expPos = payloadJson.find("\"exp\":");
+        if (subPos == std::string::npos || expPos == std::string::npos) return false;
+        subPos += 7;
+        size_t subEnd = payloadJson.find("\"", subPos);
+        sub = payloadJson.substr(subPos, subEnd - subPos);
+        expPos += 6;
+        size_t expEnd = payloadJson.find_first_of(",}", expPos);
+        exp = std::stoull(payloadJson.substr(expPos, expEnd - expPos));
+        return true;
+    }
+
+    class CredentialsHandler : public JsonHandler {
+    public:
+        JsonString<256> username;
+        JsonString<1024> password;
+
+        bool onField(const JsonField& field) override {
+            if (field.key == "username") return username.assign(field);
+            if (field.key == "password") return password.assign(field);
+            return true;
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    const std::string body = R"({"username":"benchmark_user_with_a_long_name","password":"correct horse battery staple"})";
+    const std::string payload = R"({"sub":"benchmark_user_with_a_long_name","iat":1700000000,"exp":1700000060,"typ":"access"})";
+
+    volatile size_t sink = 0;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        std::string u = legacyExtractField(body, "username");
+        std::string p = legacyExtractField(body, "password");
+        sink = sink + u.size() + p.size();
+    }
+    report("body: find() x2", iterations, secondsSince(start));
+
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        CredentialsHandler handler;
+        Json::parseObject(body, handler);
+        sink = sink + handler.username.size + handler.password.size;
+    }
+    report("body: Json::parseObject", iterations, secondsSince(start));
+
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        std::string sub;
+        uint64_t exp = 0;
+        legacyClaims(payload, sub, exp);
+        sink = sink + sub.size() + exp;
+    }
+    report("claims: find() + substr", iterations, secondsSince(start));
+
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        JwtClaims claims;
+        JWT::parseClaims(payload, claims);
+        sink = sink + claims.sub.size + claims.exp;
+    }
+    report("claims: JWT::parseClaims", iterations, secondsSince(start));
+
+    return sink == 0 ? 1 : 0;
+}
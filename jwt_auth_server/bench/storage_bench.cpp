@@ -0,0 +1,115 @@
+/**
+ * @file storage_bench.cpp
+ * @brief Сравнение движков RevocationStore (SQLite и MappedLog) на одной нагрузке.
+ *
+ * Для каждого движка измеряется:
+ * - одиночные отзывы (одна фиксация на токен, как logout без WriteQueue);
+ * - пакетные отзывы через applyBatch (как WriteQueue);
+ * - проверки isTokenBlacklisted для существующих и отсутствующих токенов;
+ * - очистка истёкших токенов порциями.
+ *
+ * Запуск: `./storage_bench [количество_токенов] [размер_пакета] [каталог]`
+ */
+#include "../include/SqliteStore.h"
+#include "../include/LogStore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::string makeToken(const char* prefix, size_t i) {
+        // Длина близка к реальному refresh токену.
+        std::string token = std::string(prefix) + std::to_string(i) + ".";
+        token.resize(300, 'x');
+        return token;
+    }
+
+    void report(const char* engine, const char* phase, size_t ops, double seconds) {
+        std::printf("%-10s %-22s %10zu ops %10.3f s %12.0f ops/s\n",
+                    engine, phase, ops, seconds, seconds > 0 ? ops / seconds : 0.0);
+    }
+
+    void runWorkload(const char* engine, RevocationStore& store, size_t count, size_t batchSize) {
+        uint64_t now = static_cast<uint64_t>(std::time(nullptr));
+        size_t single = count / 10;
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < single; ++i)
+            store.blacklistToken(makeToken("single-", i), now + 3600);
+        report(engine, "blacklist (single)", single, secondsSince(start));
+
+        start = Clock::now();
+        std::vector<WriteOp> batch;
+        std::vector<bool> results;
+        for (size_t i = 0; i < count; ++i) {
+            WriteOp op;
+            op.type = WriteOp::Type::BlacklistToken;
+            op.key = makeToken("batch-", i);
+            // Половина токенов уже истекла — их удалит purgeExpired.
+            op.expiresAt = (i % 2 == 0) ? now - 10 : now + 3600;
+            batch.push_back(std::move(op));
+            if (batch.size() == batchSize || i + 1 == count) {
+                store.applyBatch(batch, results);
+                batch.clear();
+            }
+        }
+        report(engine, "blacklist (batched)", count, secondsSince(start));
+
+        start = Clock::now();
+        size_t hits = 0;
+        for (size_t i = 0; i < count; ++i)
+            hits += store.isTokenBlacklisted(makeToken("batch-", i)) ? 1 : 0;
+        report(engine, "lookup (present)", count, secondsSince(start));
+
+        start = Clock::now();
+        for (size_t i = 0; i < count; ++i)
+            hits += store.isTokenBlacklisted(makeToken("absent-", i)) ? 1 : 0;
+        report(engine, "lookup (absent)", count, secondsSince(start));
+
+        start = Clock::now();
+        size_t purged = 0;
+        int deleted;
+        while ((deleted = store.purgeExpired(500, now)) > 0)
+            purged += static_cast<size_t>(deleted);
+        report(engine, "purge expired", purged, secondsSince(start));
+
+        if (hits != count) std::cerr << "[bench] Неожиданное число попаданий: " << hits << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t batchSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    std::string dir = argc > 3 ? argv[3] : ".";
+
+    std::string sqlitePath = dir + "/bench_storage.db";
+    std::string logPath = dir + "/bench_revocations.log";
+    std::remove(sqlitePath.c_str());
+    std::remove(logPath.c_str());
+
+    {
+        SqliteStore sqlite;
+        if (!sqlite.open(sqlitePath)) return 1;
+        runWorkload("sqlite", sqlite, count, batchSize);
+    }
+    {
+        LogRevocationStore log;
+        if (!log.open(logPath)) return 1;
+        runWorkload("mmap-log", log, count, batchSize);
+    }
+
+    std::remove(sqlitePath.c_str());
+    std::remove(logPath.c_str());
+    return 0;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "extern/httplib.h"
+#include "RSA.h"
+#include "StaticResponse.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Какой токен маршрут требует в заголовке `Authorization: Bearer <token>`.
+ */
+enum class AuthRequirement {
+    None,           ///< Маршрут открыт.
+    AccessToken,    ///< Действующий access токен.
+    RefreshToken    ///< Действующий refresh токен.
+};
+
+/**
+ * @brief Результат проверки токена, передаваемый обработчику маршрута.
+ */
+struct AuthContext {
+    std::string_view token;     ///< Токен (string_view в заголовок Authorization запроса).
+    std::string subject;        ///< Claim `sub`.
+    uint64_t expiresAt = 0;     ///< Claim `exp`.
+};
+
+/**
+ * @brief Проверка bearer токена перед вызовом обработчика маршрута.
+ *
+ * Маршрут объявляет требование (Route::auth), а middleware один раз для всех движков:
+ * - находит заголовок `Authorization` и отделяет префикс `Bearer ` (JwtView::bearerToken);
+ * - проверяет токен нужного вида открытым ключом, загруженным при запуске
+ *   (access токены — через TokenCache);
+ * - заполняет AuthContext либо возвращает фиксированный отказ.
+ *
+ * Коды и тексты отказов совпадают с прежними ответами маршрутов:
+ * для access токена 401/400, для refresh токена 400/400/401.
+ *
+ * Ключи читаются с диска один раз в configure(), а не на каждом запросе.
+ */
+class AuthMiddleware {
+public:
+    /**
+     * @brief Загружает ключи подписи и публикует открытый ключ (Jwks); вызывается из HttpServer::start().
+     *
+     * @return false, если ключи не загрузились — тогда маршруты с токенами отвечают 500 "Key error".
+     */
+    static bool configure();
+
+    /**
+     * @brief Проверяет токен, которого требует маршрут.
+     *
+     * @param requirement Требование маршрута.
+     * @param req Запрос; AuthContext::token ссылается в его заголовки.
+     * @param[out] auth Claims проверенного токена.
+     * @return nullptr, если запрос допущен, иначе фиксированный ответ с отказом.
+     */
+    static const StaticResponse* authenticate(AuthRequirement requirement, const httplib::Request& req, AuthContext& auth);
+
+    /**
+     * @brief Закрытый ключ, загруженный configure(), для выпуска токенов.
+     *
+     * @return nullptr, если ключи не загрузились.
+     */
+    static const RSAPrivateKey* signingKey();
+
+    /**
+     * @brief Открытый ключ, загруженный configure(), для проверки токенов вне маршрутов с Route::auth.
+     *
+     * @return nullptr, если ключи не загрузились.
+     */
+    static const RSAPublicKey* verificationKey();
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <cstddef>
 
 /**
  * @brief Класс для кодирования и декодирования строк в формате Base64URL.
@@ -33,6 +35,18 @@ public:
      */
     static std::string encode(const std::string& input);
 
+    /**
+     * @brief Размер результата кодирования строки длины inputLen (без `=`).
+     */
+    static size_t encodedSize(size_t inputLen);
+
+    /**
+     * @brief Дописывает Base64URL-кодировку input в конец out без логирования.
+     *
+     * Позволяет собрать несколько сегментов токена в одном заранее выделенном буфере.
+     */
+    static void encode(std::string_view input, std::string& out);
+
     /**
      * @brief Декодирует строку из формата Base64URL в исходное значение.
      * 
@@ -46,4 +60,23 @@ public:
      * @return Декодированная строка (обычно — JSON)
      */
     static std::string decode(const std::string& input);
+
+    /**
+     * @brief Максимальный размер результата декодирования строки длины encodedLen.
+     */
+    static size_t decodedSize(size_t encodedLen);
+
+    /**
+     * @brief Декодирует Base64URL в буфер вызывающего без выделения памяти и без логирования.
+     *
+     * В отличие от decode(), недопустимые символы и длины не отбрасываются молча,
+     * а приводят к ошибке — так поддельный токен отклоняется ещё до проверки подписи.
+     *
+     * @param input Строка в формате Base64URL (без `=`).
+     * @param out Буфер для результата.
+     * @param capacity Размер буфера.
+     * @param[out] outLen Количество записанных байт.
+     * @return false, если вход некорректен или результат не помещается в буфер.
+     */
+    static bool decode(std::string_view input, char* out, size_t capacity, size_t& outLen);
 };
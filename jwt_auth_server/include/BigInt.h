@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
 
 /**
  * @brief Класс для работы с большими целыми числами произвольной длины (Big Integer).
@@ -39,7 +42,7 @@ public:
      *
      * В случае hex преобразует каждую цифру в десятичное значение, домножает на соответствующую степень 16 и накапливает результат.
      */
-    BigInt(const std::string& str, int base);
+    BigInt(std::string_view str, int base);
 
     /**
      * @brief Преобразует число в строку в десятичной системе.
@@ -54,6 +57,17 @@ public:
      */
     std::string toString(int base) const;
 
+    /**
+     * @brief Записывает неотрицательное число в буфер фиксированной длины (big-endian).
+     * @param out Буфер назначения.
+     * @param len Длина буфера в байтах.
+     * @return false, если число отрицательное или не помещается в len байт.
+     *
+     * Десятичные цифры поглощаются от старшей к младшей (out = out * 10 + d) прямо в буфере,
+     * поэтому преобразование не выделяет память.
+     */
+    bool toBytes(uint8_t* out, size_t len) const;
+
     // === Арифметические операции ===
 
     /**
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <chrono>
+
+/**
+ * @brief Статистика работы фоновой очистки blacklist.
+ */
+struct BlacklistCleanerStats {
+    uint64_t runs = 0;            ///< Количество завершённых проходов очистки.
+    uint64_t batches = 0;         ///< Количество выполненных порций DELETE.
+    uint64_t rowsPurged = 0;      ///< Всего удалено истёкших токенов.
+    uint64_t errors = 0;          ///< Количество порций, завершившихся ошибкой.
+    uint64_t totalMicros = 0;     ///< Суммарное время, потраченное на очистку (мкс).
+    uint64_t lastRunMicros = 0;   ///< Длительность последнего прохода (мкс).
+    uint64_t maxBatchMicros = 0;  ///< Самая долгая порция за всё время (мкс).
+};
+
+/**
+ * @brief Фоновый поток, периодически удаляющий истёкшие токены из blacklist.
+ *
+ * Каждый проход удаляет токены порциями по batchSize строк через
+ * Database::purgeExpiredBlacklist(), делая паузу между порциями.
+ * Блокировка записи удерживается только на время одной порции,
+ * поэтому logout и регистрация не ждут окончания всей очистки.
+ *
+ * Размер таблицы blacklist таким образом остаётся пропорциональным
+ * количеству ещё действующих отозванных токенов.
+ */
+class BlacklistCleaner {
+public:
+    /**
+     * @brief Запускает фоновый поток очистки.
+     *
+     * Повторный вызов без stop() игнорируется.
+     *
+     * @param interval Интервал между проходами очистки.
+     * @param batchSize Максимальное количество строк, удаляемых одной порцией.
+     * @param batchPause Пауза между порциями внутри одного прохода.
+     */
+    static void start(std::chrono::seconds interval = std::chrono::seconds(60),
+                      int batchSize = 500,
+                      std::chrono::milliseconds batchPause = std::chrono::milliseconds(10));
+
+    /**
+     * @brief Останавливает фоновый поток и дожидается его завершения.
+     */
+    static void stop();
+
+    /**
+     * @brief Выполняет один полный проход очистки в текущем потоке.
+     *
+     * @param batchSize Максимальное количество строк в одной порции.
+     * @param batchPause Пауза между порциями.
+     */
+    static void runOnce(int batchSize, std::chrono::milliseconds batchPause);
+
+    /**
+     * @brief Возвращает снимок накопленной статистики.
+     */
+    static BlacklistCleanerStats getStats();
+};
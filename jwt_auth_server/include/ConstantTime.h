@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include "SHA256.h"
+
+/**
+ * @brief Сравнение секретных данных за постоянное время.
+ *
+ * Обычное сравнение строк (operator==, memcmp) прекращается на первом
+ * несовпавшем байте, и по времени ответа можно подбирать хеш побайтно.
+ * Здесь всегда просматриваются все байты, а результат накапливается через OR
+ * без ветвлений. Сравниваются двоичные буферы фиксированной длины на стеке,
+ * поэтому проверка не выделяет память.
+ *
+ * Используется для проверки хешей паролей и расшифрованного хеша в RSA::verify().
+ */
+class ConstantTime {
+public:
+    /**
+     * @brief Сравнивает два буфера одинаковой длины за время, зависящее только от len.
+     *
+     * @param a Первый буфер.
+     * @param b Второй буфер.
+     * @param len Длина обоих буферов в байтах.
+     * @return true, если буферы совпадают.
+     */
+    static bool equal(const void* a, const void* b, size_t len);
+
+    /**
+     * @brief Сравнивает два 32-байтных хеша SHA-256 за постоянное время.
+     */
+    static bool equal(const SHA256::Digest& a, const SHA256::Digest& b);
+};
@@ -1,21 +1,40 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <cstdint>
+#include "Storage.h"
+#include "LogStore.h"
 
 /**
- * @brief Структура, представляющая пользователя из базы данных.
+ * @brief Движок хранения для UserStore / RevocationStore.
  */
-struct User {
-    int id;                     ///< Уникальный идентификатор пользователя в таблице.
-    std::string username;       ///< Имя пользователя.
-    std::string password;       ///< Хеш пароля (уже захеширован).
+enum class StorageEngine {
+    SQLite,     ///< SqliteStore — таблицы users и blacklist в SQLite.
+    MappedLog   ///< LogUserStore / LogRevocationStore — журнал в mmap с хеш-индексом в памяти.
 };
 
 /**
- * @brief Класс-обёртка для работы с SQLite-базой данных.
+ * @brief Параметры инициализации хранилищ.
+ */
+struct StorageOptions {
+    std::string sqlitePath = "users.db";                 ///< Файл SQLite-базы (базовое имя при шардировании).
+    size_t sqliteShards = 1;                             ///< Количество шардов SQLite (см. SqliteStore::shardPaths).
+    StorageEngine userEngine = StorageEngine::SQLite;    ///< Где хранятся пользователи.
+    StorageEngine revocationEngine = StorageEngine::SQLite; ///< Где хранится blacklist.
+    std::string userLogPath = "users.log";               ///< Журнал пользователей (для MappedLog).
+    std::string revocationLogPath = "revocations.log";   ///< Журнал отзывов (для MappedLog).
+    LogStoreOptions logOptions;                          ///< Параметры журналов.
+};
+
+/**
+ * @brief Фасад для работы с хранилищами пользователей и заблокированных токенов.
  *
- * Обеспечивает доступ к таблице пользователей и таблице заблокированных (blacklisted) токенов.
+ * Обеспечивает доступ к пользователям и заблокированным (blacklisted) токенам.
  * Используется для реализации регистрации, авторизации, выхода из системы и защиты от повторного использования refresh токенов.
+ *
+ * Фактическое хранение делегируется реализациям UserStore и RevocationStore,
+ * которые выбираются при инициализации (SQLite или журнал в mmap) и могут различаться:
+ * например, пользователи в SQLite, а blacklist — в журнале.
  */
 class Database {
 public:
@@ -26,15 +45,35 @@ public:
      * - users(id, username, password)
      * - blacklist(token, expires_at)
      *
+     * а также индекс по blacklist(expires_at), чтобы очистка истёкших токенов
+     * не сканировала всю таблицу.
+     *
      * @param db_path Путь к файлу базы данных.
      * @return true, если инициализация прошла успешно; false в случае ошибки.
      */
     static bool init(const std::string& db_path);
 
+    /**
+     * @brief Инициализирует хранилища согласно параметрам.
+     *
+     * @param options Выбор движков и пути к файлам.
+     * @return true, если все хранилища открыты успешно.
+     */
+    static bool init(const StorageOptions& options);
+
+    /**
+     * @brief Закрывает хранилища: соединения SQLite (с записью WAL в базу) и журналы.
+     *
+     * Вызывается при остановке, когда запросы и WriteQueue уже завершены;
+     * после этого фасадом пользоваться нельзя.
+     */
+    static void close();
+
     /**
      * @brief Добавляет нового пользователя в таблицу users.
      *
-     * Перед вставкой хеширует пароль.
+     * Перед вставкой хеширует пароль. После вставки запись пользователя
+     * инвалидируется в UserCache.
      *
      * @param username Имя пользователя.
      * @param password Обычный текстовый пароль (будет захеширован).
@@ -42,10 +81,21 @@ public:
      */
     static bool addUser(const std::string& username, const std::string& password);
 
+    /**
+     * @brief Добавляет пользователя с уже вычисленным хешем пароля.
+     *
+     * @param username Имя пользователя.
+     * @param passwordHash Хеш пароля, полученный от PasswordEncryptor.
+     * @return true, если пользователь успешно добавлен; false, если уже существует или произошла ошибка.
+     */
+    static bool insertUser(const std::string& username, const std::string& passwordHash);
+
     /**
      * @brief Получает пользователя из базы данных по имени.
      *
      * Если пользователь найден, возвращает его через user_out.
+     * Сначала проверяется UserCache (включая негативный кэш несуществующих имён);
+     * к базе запрос выполняется только при промахе кэша.
      *
      * @param username Имя пользователя.
      * @param user_out Объект, в который будут загружены данные.
@@ -76,12 +126,50 @@ public:
      */
     static bool isTokenBlacklisted(const std::string& token);
 
+    /**
+     * @brief Проверяет пакет токенов по blacklist за один проход (POST /introspect).
+     *
+     * @param tokens Проверяемые токены.
+     * @param[out] revoked revoked[i] — отозван ли tokens[i].
+     * @return false при ошибке хранилища.
+     */
+    static bool findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked);
+
     /**
      * @brief Удаляет все устаревшие токены из blacklist (истёкшие по времени).
      *
-     * Вызывается периодически для очистки таблицы и экономии ресурсов.
+     * Удаление выполняется порциями через purgeExpiredBlacklist(), поэтому
+     * блокировка записи не удерживается на всё время очистки.
      *
      * @return true, если удаление прошло успешно; false — при ошибке выполнения запроса.
      */
     static bool cleanupBlacklist();
+
+    /**
+     * @brief Удаляет не более batchSize истёкших токенов из blacklist.
+     *
+     * Строки выбираются по индексу expires_at, поэтому стоимость одной порции
+     * пропорциональна batchSize, а не размеру таблицы.
+     *
+     * @param batchSize Максимальное количество удаляемых строк за вызов.
+     * @param now Текущее время (UNIX-время); токены с expires_at < now считаются истёкшими.
+     * @return Количество удалённых строк или -1 при ошибке.
+     */
+    static int purgeExpiredBlacklist(int batchSize, uint64_t now);
+
+    // ===== Пакетная запись =====
+
+    /**
+     * @brief Применяет набор операций записи одной транзакцией.
+     *
+     * Если пользователи и blacklist лежат в одном хранилище, весь пакет применяется
+     * одной фиксацией (одна синхронизация журнала); иначе — по одной фиксации на хранилище.
+     * Ошибка отдельной операции (например, занятое имя пользователя) не откатывает остальные.
+     *
+     * @param ops Операции записи.
+     * @param[out] results Результат каждой операции (в том же порядке, что и ops).
+     * @return true, если все фиксации прошли успешно; false, если хотя бы одна не удалась
+     *         (результаты операций этого хранилища равны false).
+     */
+    static bool applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results);
 };
@@ -0,0 +1,55 @@
+#pragma once
+#include "ServerConfig.h"
+
+#include <chrono>
+
+/**
+ * @brief HTTP/1.1 сервер на epoll: по одному циклу событий на ядро.
+ *
+ * httplib обслуживает каждое соединение отдельным потоком из пула, поэтому
+ * число одновременных keep-alive клиентов ограничено размером пула, а простаивающие
+ * соединения держат потоки. Здесь каждое ядро обслуживает свой цикл событий:
+ * - у каждого цикла собственный слушающий сокет с `SO_REUSEPORT` — ядро ОС само
+ *   распределяет входящие соединения, общего accept нет;
+ * - поток цикла закреплён за своим ядром (`pthread_setaffinity_np`);
+ * - соединение живёт в одном цикле от accept до close, поэтому его состояние
+ *   не требует блокировок, а простаивающее соединение стоит только памяти.
+ *
+ * Запросы разбираются в httplib::Request и передаются тем же обработчикам
+ * из HttpServer::routes(). Быстрые маршруты (`/secure/data`, OPTIONS) выполняются
+ * прямо в цикле. Маршруты с пометкой Route::blocking (хеширование пароля,
+ * подпись, запись в хранилище) уходят в ограниченный пул потоков, а готовый
+ * ответ возвращается в цикл через eventfd; при переполнении пула клиент сразу
+ * получает 503.
+ *
+ * Поддерживаются keep-alive, конвейерные запросы и тела с Content-Length;
+ * chunked-тела запросов отклоняются (411).
+ *
+ * При плавной остановке (drain()) цикл принимает соединения, уже стоящие в очереди
+ * его сокета, и закрывает сокет: новые соединения ядро отдаёт другим сокетам с тем же
+ * портом, в том числе сокетам нового процесса. Простаивающие keep-alive соединения
+ * закрываются, остальные получают ответ с `Connection: close`.
+ */
+class EpollServer {
+public:
+    /**
+     * @brief Запускает циклы событий и блокируется до вызова stop().
+     *
+     * @param settings Адрес, число циклов, размер пула, keep-alive, таймауты и лимиты.
+     * @return false, если не удалось открыть слушающие сокеты.
+     */
+    static bool run(const HttpSettings& settings);
+
+    /**
+     * @brief Останавливает все циклы событий; run() возвращается после их завершения.
+     */
+    static void stop();
+
+    /**
+     * @brief Плавная остановка: run() возвращается, когда начатые запросы выполнены и отправлены.
+     *
+     * Соединения, не закрывшиеся за timeout, обрываются. Можно вызвать до run():
+     * тогда циклы остановятся сразу после запуска.
+     */
+    static void drain(std::chrono::seconds timeout);
+};
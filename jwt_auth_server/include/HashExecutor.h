@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <optional>
+
+/**
+ * @brief Статистика пула хеширования паролей.
+ */
+struct HashExecutorStats {
+    uint64_t submitted = 0;        ///< Принято задач.
+    uint64_t rejected = 0;         ///< Отклонено задач из-за переполнения очереди.
+    uint64_t completed = 0;        ///< Выполнено задач.
+    uint64_t queueWaitMicros = 0;  ///< Суммарное время ожидания в очереди (мкс).
+    uint64_t workMicros = 0;       ///< Суммарное время вычисления хешей (мкс).
+    uint64_t maxQueueDepth = 0;    ///< Максимальная наблюдавшаяся длина очереди.
+};
+
+/**
+ * @brief Выделенный пул потоков для хеширования и проверки паролей.
+ *
+ * Хеширование пароля (PBKDF2/Balloon) на порядки дороже проверки подписи токена.
+ * Если выполнять его прямо в потоках HTTP-сервера, всплеск `/login` (или перебор
+ * паролей) занимает все потоки, и `/secure/data` начинает ждать.
+ *
+ * Поэтому вся работа PasswordEncryptor выносится в фиксированное число потоков
+ * с ограниченной очередью. Когда очередь заполнена, задача не принимается
+ * (возвращается std::nullopt), и обработчик сразу отвечает 503, не нагружая CPU.
+ * Таким образом на хеширование никогда не тратится больше `threads` ядер,
+ * а число ожидающих запросов не превышает capacity().
+ *
+ * Если пул не запущен, задачи выполняются синхронно в вызывающем потоке.
+ */
+class HashExecutor {
+public:
+    /**
+     * @brief Запускает потоки пула.
+     *
+     * @param threads Количество потоков хеширования.
+     * @param maxQueue Максимальное число задач, ожидающих свободного потока.
+     */
+    static void start(size_t threads, size_t maxQueue);
+
+    /**
+     * @brief Останавливает пул, предварительно выполнив задачи из очереди.
+     */
+    static void stop();
+
+    /**
+     * @brief Максимальное число одновременно принятых задач (потоки + очередь).
+     */
+    static size_t capacity();
+
+    /**
+     * @brief Ставит в очередь хеширование пароля текущими параметрами.
+     *
+     * @return Future с закодированным хешем или std::nullopt, если очередь заполнена.
+     */
+    static std::optional<std::future<std::string>> hashPassword(const std::string& password);
+
+    /**
+     * @brief Ставит в очередь проверку пароля.
+     *
+     * @return Future с результатом проверки или std::nullopt, если очередь заполнена.
+     */
+    static std::optional<std::future<bool>> verifyPassword(const std::string& password, const std::string& encoded);
+
+    /**
+     * @brief Ставит в очередь фоновую задачу, результат которой никто не ждёт.
+     *
+     * Используется для отложенной работы (например, перехеширования пароля после входа),
+     * которую можно безопасно пропустить при перегрузке.
+     *
+     * @return false, если очередь заполнена и задача отброшена.
+     */
+    static bool post(std::function<void()> task);
+
+    /**
+     * @brief Возвращает снимок статистики пула.
+     */
+    static HashExecutorStats getStats();
+};
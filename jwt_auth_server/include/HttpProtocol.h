@@ -0,0 +1,118 @@
+#pragma once
+#include "extern/httplib.h"
+#include "HttpServer.h"
+#include "ServerConfig.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct addrinfo;
+
+/**
+ * @brief Состояние HTTP/1.1 соединения, не зависящее от механизма ввода-вывода.
+ *
+ * Движок (EpollServer, UringServer) дописывает принятые байты в `in`,
+ * вызывает HttpProtocol::process() и отправляет `out`.
+ */
+struct HttpSession {
+    uint64_t id = 0;                 ///< Уникален в пределах цикла (fd переиспользуются).
+    std::string remoteAddr;          ///< IP клиента.
+    int remotePort = 0;              ///< Порт клиента.
+    std::string in;                  ///< Принятые, ещё не разобранные байты.
+    std::string out;                 ///< Ответы, ожидающие отправки.
+    size_t outOffset = 0;            ///< Сколько байт out уже отправлено.
+    size_t served = 0;               ///< Запросов обработано на соединении.
+    bool pending = false;            ///< Запрос выполняется в пуле — следующие ждут в `in`.
+    bool closeAfterWrite = false;    ///< Закрыть после отправки out.
+    bool peerClosed = false;         ///< Клиент закрыл свою сторону.
+    bool draining = false;           ///< Сервер останавливается: следующий ответ закрывает соединение.
+
+    /// Нужно ли читать дальше.
+    bool wantsRead() const { return !pending && !closeAfterWrite && !peerClosed; }
+
+    /// Есть ли неотправленные байты.
+    bool hasOutput() const { return outOffset < out.size(); }
+
+    /// Всё отправлено, в пуле ничего не выполняется и соединение пора закрыть.
+    bool finished() const { return !pending && !hasOutput() && (closeAfterWrite || peerClosed); }
+
+    /// Отмечает n байт out как отправленные.
+    void consumeOutput(size_t n) {
+        outOffset += n;
+        if (outOffset >= out.size()) {
+            out.clear();
+            outOffset = 0;
+        }
+    }
+};
+
+/**
+ * @brief Передаёт блокирующий маршрут в пул потоков.
+ *
+ * auth — токен запроса, уже допущенного HttpServer::admit() (ссылается в заголовки request).
+ *
+ * @return false, если пул переполнен (клиент получит 503).
+ */
+using HttpOffload = std::function<bool(const Route* route, std::shared_ptr<httplib::Request> request,
+                                       const AuthContext& auth, bool keepAlive)>;
+
+/**
+ * @brief Общая для событийных движков (EpollServer, UringServer) часть:
+ *        разбор запросов HTTP/1.1, выполнение маршрутов из HttpServer::routes(),
+ *        сериализация ответов и подготовка сокетов и потоков.
+ */
+class HttpProtocol {
+public:
+    /**
+     * @brief Разбирает и выполняет запросы из session.in по порядку (конвейер).
+     *
+     * Быстрые маршруты выполняются сразу, блокирующие (Route::blocking) передаются
+     * в offload — тогда session.pending остаётся true до complete(). Блокирующий маршрут
+     * допускается (HttpServer::admit()) до offload: запрос сверх лимита частоты или
+     * с негодным токеном получает отказ сразу.
+     * Ответы дописываются в session.out.
+     */
+    static void process(HttpSession& session, const HttpSettings& settings, const HttpOffload& offload);
+
+    /**
+     * @brief Принимает ответ блокирующего маршрута, выполненного в пуле.
+     */
+    static void complete(HttpSession& session, std::string response, bool close);
+
+    /**
+     * @brief Выполняет маршрут и дописывает ответ в out (вызывается и из цикла, и из пула).
+     *
+     * Фиксированный ответ (StaticResponse) дописывается готовыми байтами без сериализации.
+     */
+    static void respond(const Route* route, const httplib::Request& req, bool keepAlive, std::string& out);
+
+    /**
+     * @brief То же для маршрута, токен которого уже проверен (блокирующий маршрут в пуле).
+     */
+    static void respond(const Route& route, const httplib::Request& req, const AuthContext& auth, bool keepAlive,
+                        std::string& out);
+
+    /**
+     * @brief Дописывает в out ответ HTTP/1.1 с общими заголовками, Content-Length (кроме 204 и 304) и Connection.
+     */
+    static void serialize(const httplib::Response& res, bool keepAlive, std::string& out);
+
+    /**
+     * @brief Открывает слушающий сокет с SO_REUSEPORT.
+     *
+     * @param addr Адрес (getaddrinfo).
+     * @param backlog Очередь непринятых соединений.
+     * @param nonBlocking Открыть в неблокирующем режиме.
+     * @return Дескриптор или -1.
+     */
+    static int listenReusePort(const addrinfo* addr, int backlog, bool nonBlocking);
+
+    /**
+     * @brief Закрепляет текущий поток за index-м из доступных процессу ядер.
+     * @return Номер CPU или -1.
+     */
+    static int pinToCore(size_t index);
+};
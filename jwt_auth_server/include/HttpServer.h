@@ -1,5 +1,33 @@
 #pragma once
 #include "extern/httplib.h"
+#include "AuthMiddleware.h"
+#include "RateLimiter.h"
+#include "ServerConfig.h"
+#include "StaticResponse.h"
+
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Обработчик маршрута API.
+ *
+ * Возвращает фиксированный ответ (StaticResponses) или nullptr, если ответ записан в Response.
+ * Токен, которого требует маршрут (Route::auth), к моменту вызова уже проверен AuthMiddleware.
+ */
+using RouteHandler = const StaticResponse* (*)(const httplib::Request&, const AuthContext&, httplib::Response&);
+
+/**
+ * @brief Маршрут API — общий для всех движков HTTP-сервера.
+ */
+struct Route {
+    const char* method;     ///< HTTP-метод.
+    const char* path;       ///< Путь ("*" — любой).
+    RouteHandler handler;   ///< Обработчик.
+    bool blocking;          ///< Обработчик ждёт хеширования пароля, подписи RSA или записи в хранилище.
+    AuthRequirement auth;   ///< Токен, проверяемый до вызова обработчика.
+    RateLimitScope limit;   ///< Ограничение частоты (RateLimiter), проверяемое первым.
+};
 
 /**
  * @brief Класс для запуска HTTP-сервера авторизации.
@@ -10,18 +38,90 @@
  * - `POST /refresh` — обновление access токена по действующему refresh токену.
  * - `GET /secure/data` — доступ к защищённым данным по access токену.
  * - `POST /logout` — добавление refresh токена в blacklist.
+ * - `POST /introspect` — проверка пакета токенов (для шлюзов API).
+ * - `GET /.well-known/jwks.json` — открытые ключи в формате JWKS (Jwks).
+ * - `GET /metrics` — счётчики и гистограммы задержек для Prometheus (Metrics).
+ *
+ * Маршруты описаны одной таблицей routes(), которую используют все движки:
+ * - HttpEngine::Httplib — `cpp-httplib`, поток из пула на каждое соединение;
+ * - HttpEngine::Epoll — EpollServer, цикл событий на каждое ядро;
+ * - HttpEngine::Uring — UringServer, кольцо io_uring на каждое ядро.
  *
- * Сервер построен на базе библиотеки `cpp-httplib` и поддерживает CORS.
+ * Сервер поддерживает CORS: заголовки StaticResponses::commonHeaders() движки
+ * добавляют к каждому ответу сами.
+ *
+ * Bearer токен маршрутов `/refresh`, `/logout` и `/secure/data` проверяет AuthMiddleware
+ * до вызова обработчика (dispatch()), а частоту `/login` и `/register` ограничивает RateLimiter.
  */
 class HttpServer {
 public:
     /**
-     * @brief Запускает HTTP-сервер на заданном порту.
+     * @brief Запускает HTTP-сервер с заданными настройками и блокируется до его остановки.
      *
      * Все маршруты, связанные с авторизацией, автоматически настраиваются внутри функции.
      * Также активируется логгирование запросов и включается поддержка CORS.
      *
-     * @param port Порт, на котором будет слушать сервер (по умолчанию: 8080).
+     * Соединения обрабатывает пул из `settings.workers` потоков с очередью не длиннее
+     * `settings.maxQueuedRequests`: при переполнении новое соединение сразу закрывается,
+     * а не ждёт в очереди неограниченно долго.
+     *
+     * @param settings Адрес, пул обработчиков, keep-alive, таймауты и лимиты (см. HttpSettings).
+     * @return false, если не удалось занять порт.
+     */
+    static bool start(const HttpSettings& settings);
+
+    /**
+     * @brief Плавно останавливает сервер: start() вернётся, когда начатые запросы выполнены.
+     *
+     * Слушающие сокеты закрываются, поэтому новые соединения получает процесс, занявший
+     * тот же порт через `SO_REUSEPORT`. Следующий ответ каждого соединения уходит
+     * с `Connection: close`, простаивающие keep-alive соединения закрываются.
+     * Циклы epoll и io_uring ждут не дольше timeout, httplib дожидается своего пула.
+     *
+     * Потокобезопасна; вызванная до start(), останавливает сервер сразу после запуска.
+     */
+    static void shutdown(std::chrono::seconds timeout);
+
+    /**
+     * @brief Таблица маршрутов API.
+     */
+    static const std::vector<Route>& routes();
+
+    /**
+     * @brief Ищет маршрут по методу и пути (без строки запроса).
+     * @return Маршрут или nullptr (404).
+     */
+    static const Route* findRoute(std::string_view method, std::string_view path);
+
+    /**
+     * @brief Допускает запрос к маршруту: ограничение частоты (RateLimiter), затем токен (AuthMiddleware).
+     *
+     * @param[out] auth Claims проверенного токена.
+     * @return nullptr, если запрос допущен, иначе фиксированный ответ с отказом.
+     */
+    static const StaticResponse* admit(const Route& route, const httplib::Request& req, AuthContext& auth);
+
+    /**
+     * @brief Допускает запрос (admit()) и вызывает обработчик.
+     *
+     * @return Фиксированный ответ (в том числе отказ admit()) или nullptr, если ответ записан в res.
+     */
+    static const StaticResponse* dispatch(const Route& route, const httplib::Request& req, httplib::Response& res);
+
+    /**
+     * @brief Вызывает обработчик запроса, уже допущенного admit().
+     *
+     * Событийные движки допускают блокирующий маршрут ещё в цикле событий,
+     * чтобы отказ не занимал место в пуле.
+     */
+    static const StaticResponse* dispatch(const Route& route, const httplib::Request& req, const AuthContext& auth,
+                                          httplib::Response& res);
+
+    /**
+     * @brief Пишет в лог строку о выполненном запросе и учитывает его в Metrics.
+     *
+     * Задержка считается от `req.start_time_` — момента, когда событийный движок разобрал запрос
+     * (httplib заполняет это поле только в клиенте).
      */
-    static void start(int port = 8080);
+    static void logRequest(const httplib::Request& req, int status);
 };
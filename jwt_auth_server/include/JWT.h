@@ -1,7 +1,44 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <vector>
 #include "RSA.h"
+#include "Json.h"
+#include "TokenCodec.h"
+
+/**
+ * @brief Claims из payload токена, извлечённые за один проход Json::parseObject().
+ */
+struct JwtClaims {
+    JsonString<256> sub;    ///< Имя пользователя.
+    JsonString<16> typ;     ///< Тип токена: "access" или "refresh".
+    uint64_t iat = 0;       ///< Время выпуска.
+    uint64_t exp = 0;       ///< Время истечения.
+    bool hasIat = false;
+    bool hasExp = false;
+};
+
+/**
+ * @brief Пара токенов, выпущенная JWT::issuePair() для одного входа.
+ */
+struct TokenPair {
+    std::string accessToken;        ///< Access токен.
+    std::string refreshToken;       ///< Refresh токен.
+    uint64_t issuedAt = 0;          ///< Общий `iat` обоих токенов.
+    uint64_t accessExpiresAt = 0;   ///< `exp` access токена.
+    uint64_t refreshExpiresAt = 0;  ///< `exp` refresh токена.
+};
+
+/**
+ * @brief Результат проверки одного токена в JWT::introspect().
+ */
+struct TokenIntrospection {
+    bool active = false;                ///< Подпись, вид и срок действия в порядке.
+    TokenKind kind = TokenKind::Access; ///< Вид токена (только при active).
+    std::string subject;                ///< Claim `sub` (только при active).
+    uint64_t expiresAt = 0;             ///< Claim `exp` (только при active).
+};
 
 /**
  * @brief Класс, реализующий создание и проверку JSON Web Token (JWT).
@@ -12,11 +49,13 @@
  * Структура токена:
  * - Header: информация об алгоритме подписи и типе ("alg": "RS256", "typ": "JWT")
  * - Payload: полезные данные, включая:
+ *   - `typ` — тип токена (access или refresh), всегда первым полем,
  *   - `sub` — subject (имя пользователя),
  *   - `iat` — время создания (issued at),
- *   - `exp` — время истечения,
- *   - `typ` — тип токена (access или refresh)
+ *   - `exp` — время истечения
  * - Signature: RSA-подпись от (Base64(header) + "." + Base64(payload))
+ *
+ * Методы класса — тонкие обёртки над TokenCodec<TokenKind::Access> и TokenCodec<TokenKind::Refresh>.
  */
 class JWT {
 public:
@@ -25,8 +64,8 @@ public:
      * 
      * Алгоритм:
      * 1. Формируется JSON header: {"alg":"RS256","typ":"JWT"}
-     * 2. Формируется JSON payload с subject (имя пользователя), временем создания (iat),
-     *    временем истечения (exp), и типом токена "access".
+     * 2. Формируется JSON payload с типом токена "access", subject (имя пользователя),
+     *    временем создания (iat) и временем истечения (exp).
      * 3. Оба JSON-объекта кодируются в Base64URL.
      * 4. Выполняется хеширование SHA256 от соединённой строки: `header.payload`
      * 5. Хеш подписывается приватным RSA-ключом.
@@ -41,12 +80,35 @@ public:
                                          uint64_t expirationSeconds, 
                                          const RSAPrivateKey& privKey);
 
+    /**
+     * @brief Выпускает access и refresh токены за один вызов.
+     *
+     * В отличие от пары createAccessToken() + createRefreshToken():
+     * - время читается один раз, и оба токена получают одинаковый `iat`;
+     * - subject экранируется один раз;
+     * - обе подписываемые части `header.payload` собираются в одном буфере,
+     *   размер которого вычисляется заранее.
+     *
+     * Оба токена подписываются в вызывающем потоке: параллелизм обеспечивает пул
+     * обработчиков HTTP, а отдельный поток на каждый вход его бы только обходил.
+     *
+     * @param subject Имя пользователя
+     * @param accessExpirationSeconds Время жизни access токена (в секундах)
+     * @param refreshExpirationSeconds Время жизни refresh токена (в секундах)
+     * @param privKey Приватный RSA-ключ
+     * @return Оба токена и их временные метки
+     */
+    static TokenPair issuePair(const std::string& subject,
+                               uint64_t accessExpirationSeconds,
+                               uint64_t refreshExpirationSeconds,
+                               const RSAPrivateKey& privKey);
+
     /**
      * @brief Проверяет access-токен на подлинность и срок действия.
      * 
      * Алгоритм:
-     * 1. Токен разбивается на три части: header, payload, signature.
-     * 2. Снова вычисляется SHA256-хеш от `header.payload`.
+     * 1. Токен разбивается на три части (JwtView) без копирования.
+     * 2. SHA256-хеш вычисляется прямо по байтам `header.payload` исходной строки.
      * 3. Проверяется RSA-подпись с использованием публичного ключа.
      * 4. Проверяется тип токена ("typ": "access") в payload.
      * 5. Проверяется время истечения.
@@ -57,7 +119,7 @@ public:
      * @param outSubject Выходной параметр — имя пользователя из токена
      * @return true, если токен валиден; false — иначе
      */
-    static bool verifyAccessToken(const std::string& token, 
+    static bool verifyAccessToken(std::string_view token,
                                   const RSAPublicKey& pubKey, 
                                   std::string& outSubject);
 
@@ -87,7 +149,50 @@ public:
      * @param outSubject Выходной параметр — имя пользователя
      * @return true, если токен валиден и не просрочен; false — иначе
      */
-    static bool verifyRefreshToken(const std::string& token, 
+    static bool verifyRefreshToken(std::string_view token,
                                    const RSAPublicKey& pubKey, 
                                    std::string& outSubject);
+
+    /**
+     * @brief Проверяет refresh-токен и дополнительно возвращает время его истечения.
+     *
+     * @param token JWT refresh-токен
+     * @param pubKey Публичный RSA-ключ
+     * @param outSubject Выходной параметр — имя пользователя
+     * @param outExpiresAt Выходной параметр — значение `exp` (UNIX-время)
+     * @return true, если токен валиден и не просрочен; false — иначе
+     */
+    static bool verifyRefreshToken(std::string_view token,
+                                   const RSAPublicKey& pubKey,
+                                   std::string& outSubject,
+                                   uint64_t& outExpiresAt);
+
+    /**
+     * @brief Проверяет пакет токенов любого вида.
+     *
+     * Вид токена определяется по нему самому: токен нового формата, не являющийся access,
+     * отбрасывается AccessTokenCodec по префиксу payload ещё до RSA и проверяется как refresh.
+     * Все проверки используют один подготовленный контекст ключа (RSA::verify) и выполняются
+     * в вызывающем потоке: пакет ограничен, а параллелизм обеспечивает пул обработчиков HTTP.
+     *
+     * Отзыв токенов здесь не проверяется — это делает вызывающий (Database::findBlacklisted()).
+     *
+     * @param tokens Токены.
+     * @param pubKey Публичный RSA-ключ.
+     * @return Результат для каждого токена в том же порядке.
+     */
+    static std::vector<TokenIntrospection> introspect(const std::vector<std::string_view>& tokens,
+                                                      const RSAPublicKey& pubKey);
+
+    /**
+     * @brief Извлекает claims из декодированного payload за один проход.
+     *
+     * Неизвестные поля пропускаются; повторяющиеся claims и claims неверного типа
+     * считаются ошибкой.
+     *
+     * @param payloadJson JSON payload токена
+     * @param[out] out Извлечённые claims
+     * @return false, если JSON некорректен
+     */
+    static bool parseClaims(std::string_view payloadJson, JwtClaims& out);
 };
@@ -0,0 +1,127 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Тип значения поля JSON-объекта.
+ */
+enum class JsonType {
+    String,  ///< Строка; raw — содержимое между кавычками (escape-последовательности не раскрыты).
+    Number,  ///< Число; raw — его запись.
+    True,    ///< Литерал true.
+    False,   ///< Литерал false.
+    Null,    ///< Литерал null.
+    Object,  ///< Вложенный объект; raw — весь объект вместе со скобками.
+    Array    ///< Массив; raw — весь массив вместе со скобками.
+};
+
+/**
+ * @brief Одно поле объекта верхнего уровня (или элемент массива), переданное обработчику.
+ *
+ * Все string_view указывают в исходный JSON.
+ */
+struct JsonField {
+    std::string_view key;       ///< Имя поля (без кавычек, escape-последовательности не раскрыты).
+    JsonType type;              ///< Тип значения.
+    std::string_view raw;       ///< Значение в исходном виде (см. JsonType).
+    bool hasEscapes = false;    ///< Строка содержит `\` и требует Json::unescape().
+};
+
+/**
+ * @brief Обработчик событий однопроходного разбора (SAX).
+ */
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+
+    /**
+     * @brief Вызывается для каждого поля объекта верхнего уровня (элемента массива) в порядке следования.
+     * @return false, чтобы прервать разбор (parseObject()/parseArray() тогда вернёт false).
+     */
+    virtual bool onField(const JsonField& field) = 0;
+};
+
+/**
+ * @brief Однопроходный токенизатор JSON без выделения памяти.
+ *
+ * Разбирает объект верхнего уровня за один проход по строке и сообщает
+ * о каждом поле обработчику. Вложенные объекты и массивы проверяются
+ * на корректность и передаются целиком как raw. Пробелы, escape-последовательности
+ * в строках (включая `\"` и `\uXXXX`) обрабатываются по RFC 8259.
+ *
+ * Используется JWT (claims в payload) и HttpServer (тела запросов).
+ * Массив верхнего уровня разбирается так же, поэлементно (parseArray()).
+ */
+class Json {
+public:
+    /**
+     * @brief Разбирает JSON-объект и вызывает handler.onField() для каждого поля.
+     *
+     * @param json Текст JSON.
+     * @param handler Обработчик полей.
+     * @return false при синтаксической ошибке, лишних данных после объекта или отказе обработчика.
+     */
+    static bool parseObject(std::string_view json, JsonHandler& handler);
+
+    /**
+     * @brief Разбирает JSON-массив и вызывает handler.onField() для каждого элемента (key пуст).
+     *
+     * Обычно применяется к JsonField::raw поля типа JsonType::Array.
+     *
+     * @return false при синтаксической ошибке, лишних данных после массива или отказе обработчика.
+     */
+    static bool parseArray(std::string_view json, JsonHandler& handler);
+
+    /**
+     * @brief Раскрывает escape-последовательности строки в буфер вызывающего.
+     *
+     * `\uXXXX` (включая суррогатные пары) записывается в UTF-8.
+     *
+     * @param raw Содержимое строки между кавычками.
+     * @param out Буфер для результата.
+     * @param capacity Размер буфера.
+     * @param[out] outLen Длина результата.
+     * @return false, если последовательность некорректна или результат не помещается.
+     */
+    static bool unescape(std::string_view raw, char* out, size_t capacity, size_t& outLen);
+
+    /**
+     * @brief Дописывает строку в out, экранируя `"`, `\` и управляющие символы.
+     *
+     * Нужна при формировании JSON из пользовательских данных (например, `sub` в токене),
+     * иначе имя пользователя с кавычкой могло бы подменить соседние claims.
+     */
+    static void escape(std::string_view in, std::string& out);
+
+    /**
+     * @brief Читает неотрицательное целое из числового поля.
+     * @return false, если поле не число, число дробное/отрицательное или не помещается в uint64_t.
+     */
+    static bool toUint(const JsonField& field, uint64_t& out);
+};
+
+/**
+ * @brief Строковое значение поля в буфере фиксированного размера (на стеке).
+ *
+ * @tparam N Максимальная длина строки в байтах после раскрытия escape-последовательностей.
+ */
+template <size_t N>
+struct JsonString {
+    char data[N];
+    size_t size = 0;
+    bool present = false;   ///< Поле встретилось в JSON.
+
+    /**
+     * @brief Сохраняет строковое поле.
+     * @return false, если поле не строка, уже было задано (дубликат) или слишком длинное.
+     */
+    bool assign(const JsonField& field) {
+        if (field.type != JsonType::String || present) return false;
+        present = true;
+        return Json::unescape(field.raw, data, N, size);
+    }
+
+    std::string_view view() const { return std::string_view(data, size); }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "extern/httplib.h"
+#include "RSA.h"
+#include "StaticResponse.h"
+
+#include <string>
+
+/**
+ * @brief Набор открытых ключей (JWKS) для `GET /.well-known/jwks.json`.
+ *
+ * Сервисы, которым нужно проверять токены, забирают открытый ключ отсюда и
+ * проверяют подписи сами, не обращаясь к серверу авторизации на каждый запрос.
+ *
+ * Документ зависит только от набора ключей, поэтому при его смене (publish()):
+ * - `n` и `e` кодируются в Base64URL (big-endian, без ведущих нулей);
+ * - `kid` вычисляется как отпечаток ключа по RFC 7638;
+ * - тело, сильный ETag (SHA-256 тела) и ответы 200 и 304 сериализуются заранее.
+ *
+ * Запрос с совпадающим If-None-Match получает готовый 304 без сравнения тел.
+ *
+ * Подпись токенов этого сервера — RSA над SHA-256 без PKCS#1-дополнения, записанная
+ * hex-строкой в Base64URL; проверяющая сторона должна использовать ту же схему.
+ */
+class Jwks {
+public:
+    /**
+     * @brief Публикует набор ключей; вызывается при загрузке ключей (AuthMiddleware::configure()).
+     *
+     * @param pubKey Действующий открытый ключ.
+     * @return false, если ключ нельзя представить в JWK (отрицательный или пустой).
+     */
+    static bool publish(const RSAPublicKey& pubKey);
+
+    /**
+     * @brief Ответ на запрос JWKS: 304, если If-None-Match совпал с ETag, иначе 200 с документом.
+     *
+     * @return nullptr, если набор ключей ещё не опубликован.
+     */
+    static const StaticResponse* respond(const httplib::Request& req);
+
+    /**
+     * @brief Отпечаток ключа по RFC 7638: Base64URL(SHA-256(`{"e":...,"kty":"RSA","n":...}`)).
+     */
+    static std::string thumbprint(const RSAPublicKey& pubKey);
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <string_view>
+
+/**
+ * @brief Разобранный JWT без копирования данных.
+ *
+ * Все поля — std::string_view в исходный буфер (обычно прямо в значение
+ * заголовка `Authorization`), поэтому разбор токена не выделяет память,
+ * а SHA-256 считается непосредственно по байтам signingInput.
+ *
+ * Представление действительно, пока жив буфер, из которого оно получено.
+ */
+struct JwtView {
+    std::string_view header;        ///< Заголовок в Base64URL.
+    std::string_view payload;       ///< Полезная нагрузка в Base64URL.
+    std::string_view signature;     ///< Подпись в Base64URL.
+    std::string_view signingInput;  ///< `header.payload` — подписываемые байты.
+
+    /**
+     * @brief Разбивает токен на три сегмента.
+     *
+     * @param token Строка вида `header.payload.signature`.
+     * @param[out] out Результат разбора.
+     * @return false, если сегментов не три или какой-либо из них пуст.
+     */
+    static bool parse(std::string_view token, JwtView& out);
+
+    /**
+     * @brief Извлекает токен из значения заголовка `Authorization: Bearer <token>`.
+     *
+     * @param authorization Значение заголовка.
+     * @param[out] token Токен (string_view в authorization).
+     * @return false, если заголовок не начинается с "Bearer ".
+     */
+    static bool bearerToken(std::string_view authorization, std::string_view& token);
+};
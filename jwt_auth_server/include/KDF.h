@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "SHA256.h"
+
+/**
+ * @brief Функции выработки ключа (KDF) на основе SHA-256 для хранения паролей.
+ *
+ * Реализованы:
+ * - HMAC-SHA256 (RFC 2104);
+ * - PBKDF2-HMAC-SHA256 (RFC 8018) — стоимость регулируется числом итераций;
+ * - Balloon-SHA256 (Boneh, Corrigan-Gibbs, Schechter, 2016) — «memory-hard» функция:
+ *   стоимость регулируется объёмом памяти (числом 32-байтных блоков) и числом раундов,
+ *   что делает перебор на GPU/ASIC заметно дороже.
+ *
+ * Все функции работают с двоичными данными и не пишут в лог.
+ */
+class KDF {
+public:
+    /**
+     * @brief HMAC-SHA256.
+     *
+     * @param key Ключ произвольной длины.
+     * @param data Сообщение.
+     * @return 32-байтный MAC.
+     */
+    static SHA256::Digest hmacSha256(const std::string& key, const std::string& data);
+
+    /**
+     * @brief PBKDF2-HMAC-SHA256 с длиной результата 32 байта (один блок).
+     *
+     * @param password Пароль.
+     * @param salt Соль.
+     * @param iterations Количество итераций (не меньше 1).
+     * @return Выработанный ключ.
+     */
+    static SHA256::Digest pbkdf2Sha256(const std::string& password, const std::string& salt, uint32_t iterations);
+
+    /**
+     * @brief Balloon hashing на SHA-256 (delta = 3).
+     *
+     * @param password Пароль.
+     * @param salt Соль.
+     * @param spaceCost Количество 32-байтных блоков памяти (не меньше 1).
+     * @param timeCost Количество раундов перемешивания (не меньше 1).
+     * @return Выработанный ключ.
+     */
+    static SHA256::Digest balloonSha256(const std::string& password, const std::string& salt,
+                                        uint32_t spaceCost, uint32_t timeCost);
+};
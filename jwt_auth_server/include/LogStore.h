@@ -0,0 +1,99 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <shared_mutex>
+#include <unordered_map>
+#include <queue>
+#include <vector>
+#include "Storage.h"
+#include "MappedLog.h"
+
+/**
+ * @brief Параметры хранилищ на основе MappedLog.
+ */
+struct LogStoreOptions {
+    size_t reserveBytes = size_t(1) << 30;   ///< Максимальный размер файла журнала.
+    bool syncOnCommit = true;                ///< Вызывать msync после каждой фиксации.
+    double compactGarbageRatio = 0.5;        ///< Доля «мёртвых» байт, после которой журнал компактируется.
+    uint64_t compactMinBytes = 1 << 20;      ///< Журналы меньше этого размера не компактируются.
+};
+
+/**
+ * @brief Хранилище пользователей в журнале «только на дописывание».
+ *
+ * Каждая регистрация дописывает запись (id, username, hash) в MappedLog;
+ * замена хеша пароля дописывает новую запись с тем же id, вытесняющую старую из индекса.
+ * В памяти держится хеш-индекс username → смещение записи; ключи индекса —
+ * std::string_view прямо в отображённый файл, поэтому индекс не копирует строки.
+ * Индекс полностью восстанавливается сканированием журнала при старте.
+ */
+class LogUserStore : public UserStore {
+public:
+    /**
+     * @brief Открывает журнал пользователей и строит индекс.
+     */
+    bool open(const std::string& path, const LogStoreOptions& options = LogStoreOptions());
+
+    bool insertUser(const std::string& username, const std::string& passwordHash) override;
+    LookupResult findUser(const std::string& username, User& user_out) override;
+    bool applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) override;
+
+    /**
+     * @brief Переписывает журнал, оставляя только актуальные записи.
+     */
+    bool compact();
+
+private:
+    bool appendUser(const std::string& username, const std::string& passwordHash, int id);
+    void indexRecord(const MappedLog::Record& record, uint64_t offset);
+    void maybeCompact();
+    bool compactLocked();
+
+    std::shared_mutex mutex;
+    MappedLog log;
+    LogStoreOptions options;
+    std::unordered_map<std::string_view, uint64_t> index; ///< username → смещение записи.
+    uint64_t liveBytes = 0;
+    int nextId = 1;
+};
+
+/**
+ * @brief Хранилище отозванных токенов в журнале «только на дописывание».
+ *
+ * Отзыв токена — одна дописанная запись и одна вставка в хеш-индекс, без B-дерева и журнала
+ * транзакций SQLite. Истёкшие токены удаляются из индекса по min-куче времени истечения;
+ * место в файле освобождается компактированием, которое запускается из purgeExpired(),
+ * когда доля мёртвых записей превышает LogStoreOptions::compactGarbageRatio.
+ */
+class LogRevocationStore : public RevocationStore {
+public:
+    /**
+     * @brief Открывает журнал отзывов и строит индекс (уже истёкшие токены пропускаются).
+     */
+    bool open(const std::string& path, const LogStoreOptions& options = LogStoreOptions());
+
+    bool blacklistToken(const std::string& token, uint64_t expires_at) override;
+    bool isTokenBlacklisted(const std::string& token) override;
+    bool findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked) override;
+    int purgeExpired(int batchSize, uint64_t now) override;
+    bool applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) override;
+
+    /**
+     * @brief Переписывает журнал, оставляя только ещё не удалённые токены.
+     */
+    bool compact();
+
+private:
+    using Expiry = std::pair<uint64_t, std::string_view>;
+
+    bool appendToken(const std::string& token, uint64_t expires_at);
+    void indexRecord(const MappedLog::Record& record, uint64_t now);
+    bool compactLocked();
+
+    std::shared_mutex mutex;
+    MappedLog log;
+    LogStoreOptions options;
+    std::unordered_map<std::string_view, uint64_t> index; ///< token → expires_at.
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> expiries;
+    uint64_t liveBytes = 0;
+};
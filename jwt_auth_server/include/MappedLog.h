@@ -0,0 +1,120 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Файл-журнал «только на дописывание», отображённый в память (mmap).
+ *
+ * Формат файла:
+ * - заголовок 16 байт (`JWTLOG` + версия);
+ * - последовательность записей, каждая выровнена на 8 байт:
+ *   ```
+ *   u32 checksum | u32 type | u32 keyLen | u32 valueLen | u64 num | key | value | padding
+ *   ```
+ *   checksum — FNV-1a от всех байт записи после поля checksum.
+ *
+ * Под файл заранее резервируется непрерывный диапазон виртуальной памяти
+ * размером reserveBytes, а сам файл растёт через ftruncate. Поэтому адреса
+ * записей стабильны, и индексы могут хранить std::string_view прямо в отображение.
+ *
+ * При открытии журнал сканируется до первой повреждённой записи; «оборванный»
+ * хвост (например, после падения во время записи) отбрасывается.
+ *
+ * Класс не потокобезопасен — синхронизацию обеспечивает владелец.
+ */
+class MappedLog {
+public:
+    /**
+     * @brief Запись журнала. key и value указывают в отображённую память.
+     */
+    struct Record {
+        uint32_t type = 0;        ///< Тип записи (0 зарезервирован как «пусто»).
+        uint64_t num = 0;         ///< Числовое поле (идентификатор, время истечения и т.п.).
+        std::string_view key;     ///< Ключ записи.
+        std::string_view value;   ///< Значение записи.
+    };
+
+    MappedLog() = default;
+    ~MappedLog();
+
+    MappedLog(const MappedLog&) = delete;
+    MappedLog& operator=(const MappedLog&) = delete;
+
+    /**
+     * @brief Открывает (или создаёт) журнал и сканирует существующие записи.
+     *
+     * @param path Путь к файлу журнала.
+     * @param reserveBytes Максимальный размер журнала (резерв виртуальной памяти).
+     * @param onRecord Вызывается для каждой корректной записи в порядке дописывания.
+     * @return true при успехе.
+     */
+    bool open(const std::string& path, size_t reserveBytes,
+              const std::function<void(const Record&, uint64_t offset)>& onRecord);
+
+    /**
+     * @brief Закрывает журнал и снимает отображение.
+     */
+    void close();
+
+    /**
+     * @brief Дописывает запись в конец журнала (без синхронизации с диском).
+     *
+     * @param record Записываемые данные.
+     * @param[out] offset Смещение новой записи.
+     * @param[out] stored Запись, ссылающаяся на данные внутри журнала.
+     * @return false, если журнал переполнен или не удалось увеличить файл.
+     */
+    bool append(const Record& record, uint64_t& offset, Record& stored);
+
+    /**
+     * @brief Синхронизирует с диском всё, что было дописано после предыдущего sync().
+     */
+    bool sync();
+
+    /**
+     * @brief Читает запись по смещению, полученному из append() или open().
+     */
+    Record at(uint64_t offset) const;
+
+    /**
+     * @brief Перезаписывает журнал, оставляя только переданные записи (компактирование).
+     *
+     * Новый файл пишется рядом, синхронизируется, отображается в отдельный диапазон
+     * и только затем атомарно заменяет старый через rename (с синхронизацией каталога).
+     * onRecord вызывается для каждой записи нового журнала до замены, пока старое
+     * отображение ещё действует, поэтому владелец строит новый индекс во временной
+     * таблице. После успешного вызова все ранее полученные Record и смещения недействительны.
+     *
+     * @param live Записи, которые нужно сохранить.
+     * @param onRecord Вызывается для каждой записи нового журнала.
+     * @return true при успехе; при ошибке журнал и его отображение остаются прежними.
+     */
+    bool rewrite(const std::vector<Record>& live,
+                 const std::function<void(const Record&, uint64_t offset)>& onRecord);
+
+    /**
+     * @brief Количество байт, занятых заголовком и записями.
+     */
+    uint64_t size() const { return used; }
+
+    /**
+     * @brief Размер записи на диске с учётом заголовка и выравнивания.
+     */
+    static uint64_t recordSize(const Record& record);
+
+private:
+    bool mapFile(const std::string& filePath, size_t reserveBytes);
+    void swap(MappedLog& other);
+    bool ensureCapacity(uint64_t required);
+
+    std::string path;            ///< Путь к файлу журнала.
+    int fd = -1;                 ///< Дескриптор файла.
+    char* base = nullptr;        ///< Начало отображения.
+    size_t reserved = 0;         ///< Размер зарезервированного отображения.
+    uint64_t fileSize = 0;       ///< Текущий размер файла.
+    uint64_t used = 0;           ///< Конец последней корректной записи.
+    uint64_t synced = 0;         ///< Граница, до которой данные синхронизированы.
+};
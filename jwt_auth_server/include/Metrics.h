@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Этапы обработки, время которых измеряет StageTimer.
+ */
+enum class MetricStage {
+    Sha256,         ///< SHA256::digest().
+    RsaSign,        ///< RSA::sign().
+    RsaVerify,      ///< RSA::verify().
+    Base64Encode,   ///< Base64URL::encode().
+    Base64Decode,   ///< Base64URL::decode().
+    Sqlite,         ///< Вызов SqliteStore (запрос или транзакция пакета).
+    KeyLoad,        ///< KeyStorage::loadKeys().
+    Count
+};
+
+/**
+ * @brief Счётчики и гистограммы задержек для `GET /metrics` в текстовом формате Prometheus.
+ *
+ * Каждый поток пишет в собственный блок счётчиков: запись — это load и store
+ * без атомарного read-modify-write и без общих кэш-линий. Блок берётся из общего
+ * списка при первой записи потока и возвращается в него при завершении потока
+ * (счётчики сохраняются и продолжают расти у следующего владельца), поэтому
+ * короткоживущие потоки (std::async в JWT::introspect) не раздувают список.
+ * Блоки складываются только при чтении (render()).
+ *
+ * Гистограммы лог-линейные, как в HDR Histogram: каждая степень двойки наносекунд
+ * делится на 4 равных интервала (погрешность не больше 25%), от наносекунд до ~34 с.
+ *
+ * Запросы учитываются по маршруту (индекс в HttpServer::routes()) и коду ответа,
+ * задержка — по маршруту.
+ */
+class Metrics {
+public:
+    static constexpr size_t MAX_ROUTES = 16;          ///< Маршрутов с отдельными счётчиками (остальные — в последнем).
+    static constexpr uint64_t UNTIMED = UINT64_MAX;   ///< Время запроса неизвестно.
+
+    /**
+     * @brief Задаёт метки маршрутов для render(), например `method="GET",route="/secure/data"`.
+     *
+     * Индекс метки совпадает с индексом маршрута в recordRequest().
+     */
+    static void setRoutes(const std::vector<std::string>& labels);
+
+    /**
+     * @brief Учитывает выполненный запрос.
+     *
+     * @param route Индекс маршрута (см. setRoutes()).
+     * @param status Код ответа.
+     * @param nanos Время обработки или UNTIMED, если оно неизвестно (учитывается только счётчик).
+     */
+    static void recordRequest(size_t route, int status, uint64_t nanos);
+
+    /**
+     * @brief Учитывает один проход этапа.
+     */
+    static void recordStage(MetricStage stage, uint64_t nanos);
+
+    /**
+     * @brief Дописывает в out все метрики в текстовом формате Prometheus 0.0.4.
+     */
+    static void render(std::string& out);
+
+    /**
+     * @brief Дописывает в out один счётчик (`counter`) или значение (`gauge`) без меток.
+     */
+    static void appendValue(std::string& out, const char* name, const char* type, const char* help, uint64_t value);
+
+    /**
+     * @brief Монотонное время в наносекундах.
+     */
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+/**
+ * @brief Измеряет время этапа от создания до выхода из области видимости.
+ */
+class StageTimer {
+public:
+    explicit StageTimer(MetricStage stage) : stage(stage), start(Metrics::now()) {}
+    ~StageTimer() { Metrics::recordStage(stage, Metrics::now() - start); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    MetricStage stage;
+    uint64_t start;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "BigInt.h"
+
+/**
+ * @brief Модуль в форме Монтгомери для быстрого возведения в малую степень.
+ *
+ * BigInt хранит десятичные цифры, и BigInt::modPow на каждом шаге делит
+ * в столбик. Здесь модуль хранится в 32-битных словах (младшие первыми),
+ * а умножение по модулю выполняется редукцией Монтгомери (CIOS) без делений.
+ * Константы `-n^-1 mod 2^32` и `R^2 mod n` вычисляются один раз в create(),
+ * поэтому контекст создаётся для ключа заранее и переиспользуется.
+ *
+ * Для публичных экспонент выбирается специализированная цепочка:
+ * - e = 65537: 16 возведений в квадрат и одно умножение;
+ * - e = 3: одно возведение в квадрат и одно умножение;
+ * - прочие e до 2^32: бинарное возведение слева направо.
+ *
+ * Используется в RSA::verify().
+ */
+class MontgomeryContext {
+public:
+    static const size_t MAX_LIMBS = 128;  ///< Наибольший модуль — 4096 бит.
+
+    /**
+     * @brief Строит контекст для модуля.
+     *
+     * @param modulus Модуль (нечётный, больше 1, не длиннее MAX_LIMBS слов).
+     * @return Контекст или nullptr, если модуль не подходит.
+     */
+    static std::shared_ptr<const MontgomeryContext> create(const BigInt& modulus);
+
+    /**
+     * @brief Длина модуля в байтах.
+     */
+    size_t byteLength() const;
+
+    /**
+     * @brief Вычисляет `base^exponent mod n`.
+     *
+     * @param base Основание (big-endian, допускаются ведущие нули), должно быть меньше модуля.
+     * @param baseLen Длина основания в байтах.
+     * @param exponent Показатель степени (больше 0).
+     * @param out Буфер результата (big-endian).
+     * @param outLen Длина буфера.
+     * @return false, если основание не меньше модуля или результат не помещается в outLen байт.
+     */
+    bool modPow(const uint8_t* base, size_t baseLen, uint32_t exponent, uint8_t* out, size_t outLen) const;
+
+private:
+    std::vector<uint32_t> n;    ///< Модуль, младшие слова первыми.
+    std::vector<uint32_t> rr;   ///< R^2 mod n, где R = 2^(32 * n.size()).
+    uint32_t n0inv = 0;         ///< -n^-1 mod 2^32.
+    size_t bytes = 0;           ///< Длина модуля в байтах.
+
+    /**
+     * @brief out = a * b * R^-1 mod n. out может совпадать с a или b.
+     */
+    void mul(const uint32_t* a, const uint32_t* b, uint32_t* out) const;
+};
@@ -1,26 +1,94 @@
 #pragma once
 #include <string>
+#include <cstdint>
+#include <chrono>
+
+/**
+ * @brief Алгоритм хеширования пароля.
+ */
+enum class PasswordAlgorithm {
+    LegacySHA256,  ///< Несолёный SHA-256 в hex (старый формат, только проверка).
+    PBKDF2,        ///< PBKDF2-HMAC-SHA256.
+    Balloon        ///< Balloon-SHA256 (memory-hard).
+};
+
+/**
+ * @brief Параметры хеширования пароля.
+ */
+struct PasswordHashParams {
+    PasswordAlgorithm algorithm = PasswordAlgorithm::PBKDF2; ///< Алгоритм для новых хешей.
+    uint32_t iterations = 100000;   ///< Итерации PBKDF2.
+    uint32_t memoryBlocks = 16384;  ///< Объём памяти Balloon в 32-байтных блоках (16384 = 512 КиБ).
+    uint32_t rounds = 3;            ///< Раунды Balloon.
+    uint32_t saltBytes = 16;        ///< Длина соли в байтах.
+};
 
 /**
  * @brief Утилита для безопасного хеширования паролей.
  *
- * Класс предоставляет простой интерфейс для получения хеш-значения пароля
- * с использованием алгоритма SHA-256. Используется для хранения паролей в базе данных
- * в виде хеша, чтобы предотвратить компрометацию даже при утечке базы данных.
- *
- * Принцип работы:
- * - На вход подаётся строка (пароль)
- * - Производится хеширование по алгоритму SHA-256
- * - Результатом является строка длиной 64 символа в шестнадцатеричном виде
+ * Пароль хешируется солёной функцией выработки ключа (см. KDF) с настраиваемой стоимостью.
+ * Все параметры сохраняются вместе с хешем в колонке `users.password` в виде строки:
+ * ```
+ * $pbkdf2-sha256$i=<итерации>$<соль hex>$<хеш hex>
+ * $balloon-sha256$s=<блоки>,t=<раунды>$<соль hex>$<хеш hex>
+ * ```
+ * Поэтому изменение параметров не ломает проверку ранее сохранённых паролей.
+ * Старые записи — несолёный SHA-256 (64 hex-символа) — по-прежнему проверяются.
  *
+ * Стоимость хеширования напрямую определяет пропускную способность `/login`;
+ * calibrate() подбирает параметры под целевое время одного хеша на текущем железе.
  */
 class PasswordEncryptor {
 public:
     /**
-     * @brief Хеширует пароль с использованием SHA-256.
+     * @brief Устанавливает параметры для новых хешей.
+     */
+    static void configure(const PasswordHashParams& params);
+
+    /**
+     * @brief Возвращает текущие параметры хеширования.
+     */
+    static PasswordHashParams currentParams();
+
+    /**
+     * @brief Хеширует пароль текущим алгоритмом со случайной солью.
      *
      * @param password Открытый (plaintext) пароль пользователя
-     * @return Строка длиной 64 символа — хеш пароля в hex-формате
+     * @return Закодированная строка с параметрами, солью и хешем
      */
     static std::string hashPassword(const std::string& password);
+
+    /**
+     * @brief Хеширует пароль с явно заданными параметрами.
+     */
+    static std::string hashPassword(const std::string& password, const PasswordHashParams& params);
+
+    /**
+     * @brief Проверяет пароль по сохранённой строке (любого поддерживаемого формата).
+     *
+     * @param password Введённый пароль
+     * @param encoded Значение колонки `users.password`
+     * @return true, если пароль верный
+     */
+    static bool verifyPassword(const std::string& password, const std::string& encoded);
+
+    /**
+     * @brief Проверяет, устарел ли сохранённый хеш относительно текущих параметров.
+     *
+     * Устаревшим считается старый несолёный SHA-256, другой алгоритм или меньшая стоимость.
+     * Вызывается после успешной проверки пароля, чтобы перехешировать его текущей схемой.
+     */
+    static bool needsRehash(const std::string& encoded);
+
+    /**
+     * @brief Подбирает стоимость хеширования под целевое время одного хеша.
+     *
+     * Для PBKDF2 подбирается число итераций, для Balloon — объём памяти (число раундов фиксировано).
+     * Замер повторяется несколько раз, берётся минимальное время.
+     *
+     * @param algorithm Алгоритм, для которого выполняется калибровка.
+     * @param target Желаемое время вычисления одного хеша.
+     * @return Параметры, дающие примерно target на текущем железе.
+     */
+    static PasswordHashParams calibrate(PasswordAlgorithm algorithm, std::chrono::milliseconds target);
 };
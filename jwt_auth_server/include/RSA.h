@@ -1,5 +1,6 @@
 #pragma once
 #include "BigInt.h"
+#include "SHA256.h"
 
 /**
  * @brief Структура для хранения открытого (публичного) ключа RSA.
@@ -96,4 +97,39 @@ public:
     static bool verify(const std::string& messageHashHex,
                        const BigInt& signature,
                        const RSAPublicKey& key);
+
+    /**
+     * @brief Проверяет цифровую подпись по двоичному хешу сообщения.
+     *
+     * `signature^e mod n` переводится в 32-байтный буфер на стеке и сравнивается
+     * с messageHash через ConstantTime::equal() — без hex-строк и без раннего выхода.
+     *
+     * @param messageHash Ожидаемый SHA-256 хеш сообщения
+     * @param signature Подпись
+     * @param key Открытый ключ
+     * @return true, если подпись валидна; false — иначе
+     */
+    static bool verify(const SHA256::Digest& messageHash,
+                       const BigInt& signature,
+                       const RSAPublicKey& key);
+
+    /**
+     * @brief Проверяет цифровую подпись, заданную байтами (big-endian).
+     *
+     * Для публичной экспоненты до 2^32 (обычно 65537 или 3) `signature^e mod n`
+     * вычисляется в форме Монтгомери (см. MontgomeryContext) без BigInt.
+     * Контекст строится при первой проверке ключом и кэшируется, пока ключ не сменится.
+     * Прочие ключи проверяются через BigInt::modPow.
+     *
+     * Подпись, не меньшая модуля, отклоняется.
+     *
+     * @param messageHash Ожидаемый SHA-256 хеш сообщения
+     * @param signature Байты подписи
+     * @param signatureLen Длина подписи в байтах
+     * @param key Открытый ключ
+     * @return true, если подпись валидна; false — иначе
+     */
+    static bool verify(const SHA256::Digest& messageHash,
+                       const uint8_t* signature, size_t signatureLen,
+                       const RSAPublicKey& key);
 };
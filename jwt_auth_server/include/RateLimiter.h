@@ -0,0 +1,85 @@
+#pragma once
+#include "extern/httplib.h"
+#include "StaticResponse.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Маршруты, доступ к которым ограничивает RateLimiter.
+ */
+enum class RateLimitScope {
+    None,       ///< Без ограничения.
+    Login,      ///< POST /login.
+    Register    ///< POST /register.
+};
+
+/**
+ * @brief Корзина токенов: `requests` запросов подряд, затем по одному каждые `periodSec / requests` секунд.
+ */
+struct RateLimit {
+    uint32_t requests = 0;      ///< Ёмкость корзины (0 — ограничение выключено).
+    uint32_t periodSec = 60;    ///< За сколько секунд пустая корзина наполняется целиком.
+};
+
+/**
+ * @brief Ограничения для маршрутов RateLimitScope: по IP клиента и по имени пользователя.
+ */
+struct RateLimitSettings {
+    RateLimit loginPerClient{20, 60};     ///< /login с одного IP.
+    RateLimit loginPerUser{10, 60};       ///< /login с одним username.
+    RateLimit registerPerClient{10, 60};  ///< /register с одного IP.
+    RateLimit registerPerUser{5, 60};     ///< /register с одним username.
+};
+
+/**
+ * @brief Счётчики ограничителя.
+ */
+struct RateLimiterStats {
+    uint64_t limited = 0;     ///< Запросов отклонено с 429.
+    uint64_t untracked = 0;   ///< Ключей не учтено: шард заполнен (запрос пропущен).
+    uint64_t evicted = 0;     ///< Удалено простаивающих корзин.
+    uint64_t buckets = 0;     ///< Корзин сейчас в таблице.
+};
+
+/**
+ * @brief Ограничение частоты /login и /register до обращения к хранилищу и хешированию.
+ *
+ * Каждый ключ (IP клиента или username в пределах маршрута) — корзина токенов с ленивым
+ * пополнением. Корзина хранится одним атомарным словом — моментом, когда она снова
+ * станет полной: запрос сдвигает его на период одного токена через compare-exchange,
+ * так что проверка не берёт мьютекс и не пересчитывает корзину по таймеру.
+ *
+ * Таблица корзин разбита на шарды по хешу ключа. Поиск идёт под разделяемой
+ * блокировкой шарда, исключительная нужна только для новой корзины и для
+ * вычистки: раз в несколько секунд шард удаляет корзины, которые уже полны
+ * (простаивающий клиент неотличим от нового). Размер шарда ограничен; ключ,
+ * которому не хватило места, не учитывается, но IP клиента всё равно проверяется.
+ *
+ * Отказ — готовый ответ 429 с `Retry-After`, через сколько секунд появится токен.
+ */
+class RateLimiter {
+public:
+    /**
+     * @brief Задаёт ограничения, очищает таблицу и готовит ответы 429; вызывается из HttpServer::start().
+     *
+     * @param settings Ёмкость и период для каждого маршрута и ключа.
+     * @param shards Количество шардов.
+     * @param maxBuckets Наибольшее число корзин во всех шардах.
+     */
+    static void configure(const RateLimitSettings& settings, size_t shards = 16, size_t maxBuckets = 100000);
+
+    /**
+     * @brief Забирает токен у IP клиента и у username из тела запроса.
+     *
+     * Тело разбирается только ради поля `username`; без него проверяется лишь IP.
+     *
+     * @return nullptr, если запрос допущен, иначе ответ 429 с Retry-After.
+     */
+    static const StaticResponse* admit(RateLimitScope scope, const httplib::Request& req);
+
+    /**
+     * @brief Возвращает снимок счётчиков.
+     */
+    static RateLimiterStats getStats();
+};
@@ -1,5 +1,8 @@
 #pragma once
 #include <string>
+#include <array>
+#include <cstdint>
+#include <cstddef>
 
 /**
  * @brief Реализация криптографического хеш-функции SHA-256.
@@ -16,6 +19,37 @@
  */
 class SHA256 {
 public:
+    static constexpr size_t DIGEST_SIZE = 32;          ///< Размер хеша в байтах.
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;   ///< Хеш в двоичном виде.
+
+    /**
+     * @brief Потоковое вычисление SHA-256 без промежуточных аллокаций и логирования.
+     *
+     * Используется там, где хеш считается многократно (HMAC, PBKDF2, Balloon):
+     * данные подаются порциями через update(), результат забирается через finish().
+     * Контекст можно копировать, чтобы переиспользовать уже поглощённый префикс.
+     */
+    class Context {
+    public:
+        Context();
+
+        /**
+         * @brief Добавляет данные к хешируемому сообщению.
+         */
+        void update(const void* data, size_t len);
+
+        /**
+         * @brief Завершает вычисление (паддинг + длина) и возвращает хеш.
+         */
+        Digest finish();
+
+    private:
+        std::array<uint32_t, 8> state;  ///< Текущее состояние h0..h7.
+        uint8_t buffer[64];             ///< Неполный блок.
+        size_t bufferLen = 0;           ///< Заполненность buffer.
+        uint64_t totalLen = 0;          ///< Общая длина сообщения в байтах.
+    };
+
     /**
      * @brief Вычисляет SHA-256 хеш от входной строки.
      *
@@ -23,4 +57,27 @@ public:
      * @return Хеш в шестнадцатеричном виде (64 символа).
      */
     static std::string hash(const std::string& input);
+
+    /**
+     * @brief Вычисляет SHA-256 в двоичном виде (без логирования).
+     *
+     * @param data Указатель на данные.
+     * @param len Длина данных в байтах.
+     * @return 32-байтный хеш.
+     */
+    static Digest digest(const void* data, size_t len);
+
+    /**
+     * @brief Переводит двоичный хеш в шестнадцатеричную строку (64 символа).
+     */
+    static std::string toHex(const Digest& digest);
+
+    /**
+     * @brief Разбирает 64 hex-символа в двоичный хеш.
+     *
+     * @param hex Строка из 64 шестнадцатеричных символов (регистр не важен).
+     * @param[out] out Результат.
+     * @return false, если длина или символы некорректны.
+     */
+    static bool fromHex(const std::string& hex, Digest& out);
 };
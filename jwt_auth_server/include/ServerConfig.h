@@ -0,0 +1,93 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <optional>
+#include "Database.h"
+#include "PasswordEncryptor.h"
+#include "RateLimiter.h"
+
+/**
+ * @brief Движок HTTP-сервера.
+ */
+enum class HttpEngine {
+    Httplib,   ///< cpp-httplib: поток из пула на соединение.
+    Epoll,     ///< EpollServer: цикл событий epoll на каждое ядро.
+    Uring      ///< UringServer: кольцо io_uring на каждое ядро.
+};
+
+/**
+ * @brief Параметры HTTP-сервера.
+ */
+struct HttpSettings {
+    HttpEngine engine = HttpEngine::Httplib; ///< Движок.
+    std::string host = "0.0.0.0";       ///< Адрес прослушивания.
+    int port = 8080;                    ///< Порт.
+    size_t eventLoops = 0;              ///< Циклов событий для Epoll/Uring (0 — по числу ядер).
+    size_t workers = 0;                 ///< Потоков-обработчиков сверх HashExecutor::capacity() (0 — CPPHTTPLIB_THREAD_POOL_COUNT).
+    size_t maxQueuedRequests = 512;     ///< Соединений, ожидающих обработчика (0 — без ограничения).
+    size_t keepAliveMaxCount = 100;     ///< Запросов на одно keep-alive соединение.
+    int keepAliveTimeoutSec = 5;        ///< Простой keep-alive соединения до закрытия.
+    int readTimeoutSec = 5;             ///< Таймаут чтения запроса.
+    int writeTimeoutSec = 5;            ///< Таймаут записи ответа.
+    int listenBacklog = 128;            ///< Очередь ещё не принятых соединений (listen backlog).
+    size_t payloadMaxBytes = 64 * 1024; ///< Наибольший размер тела запроса.
+    int shutdownTimeoutSec = 10;        ///< Сколько при остановке ждать начатые запросы.
+    RateLimitSettings rateLimits;       ///< Ограничения частоты /login и /register.
+};
+
+/**
+ * @brief Все настраиваемые параметры сервера.
+ */
+struct ServerSettings {
+    HttpSettings http;                                           ///< HTTP-сервер.
+    StorageOptions storage;                                      ///< Хранилища.
+    PasswordAlgorithm passwordAlgorithm = PasswordAlgorithm::PBKDF2; ///< Алгоритм новых хешей паролей.
+    int passwordHashMs = 0;                                      ///< Целевое время одного хеша (0 — без калибровки).
+    size_t hashThreads = 0;                                      ///< Потоков HashExecutor (0 — половина ядер).
+    std::optional<size_t> hashQueue;                             ///< Очередь HashExecutor (по умолчанию hashThreads * 4).
+    int blacklistCleanupIntervalSec = 60;                        ///< Интервал между проходами BlacklistCleaner.
+    int blacklistCleanupBatch = 500;                             ///< Строк, удаляемых BlacklistCleaner одной порцией.
+    size_t writeBatchSize = 64;                                  ///< Наибольший размер пачки WriteQueue.
+    int writeBatchDelayUs = 2000;                                ///< Сколько WriteQueue ждёт добора пачки, мкс.
+};
+
+/**
+ * @brief Загрузка настроек сервера из файла, окружения и командной строки.
+ *
+ * Каждый параметр имеет одно имя, которое используется во всех источниках:
+ * - в файле — строка `имя = значение` (`#` начинает комментарий);
+ * - в окружении — `JWT_<ИМЯ>` (дефисы заменяются на `_`), например `JWT_KEEP_ALIVE_TIMEOUT`;
+ * - в командной строке — `--имя=значение` или `--имя значение`.
+ *
+ * Источники применяются по возрастанию приоритета: значения по умолчанию,
+ * файл (`--config` или `JWT_CONFIG`), окружение, командная строка.
+ * Переменные, существовавшие раньше (JWT_USER_STORE, JWT_SQLITE_SHARDS,
+ * JWT_PASSWORD_HASH, JWT_HASH_THREADS и др.), сохранили свои имена.
+ */
+class ServerConfig {
+public:
+    /**
+     * @brief Собирает настройки из всех источников.
+     *
+     * @param argc Число аргументов main().
+     * @param argv Аргументы main().
+     * @param[out] out Итоговые настройки.
+     * @return false при неизвестном параметре, некорректном значении или ошибке чтения файла.
+     */
+    static bool load(int argc, char* argv[], ServerSettings& out);
+
+    /**
+     * @brief Проверяет, запрошена ли справка (`--help` или `-h`).
+     */
+    static bool helpRequested(int argc, char* argv[]);
+
+    /**
+     * @brief Печатает список параметров с описанием.
+     */
+    static void printUsage(const char* program);
+
+    /**
+     * @brief Печатает действующие настройки в лог.
+     */
+    static void print(const ServerSettings& settings);
+};
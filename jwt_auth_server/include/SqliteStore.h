@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "Storage.h"
+
+struct sqlite3;
+
+/**
+ * @brief Хранилище пользователей и blacklist на основе SQLite, разбитое на шарды.
+ *
+ * Каждый шард — отдельный файл SQLite с двумя таблицами:
+ * - users(id, username, password)
+ * - blacklist(token, expires_at) с индексом по expires_at.
+ *
+ * Пользователь попадает в шард по стабильному хешу (FNV-1a) имени, токен — по хешу токена.
+ * У каждого шарда своё соединение для записи, своё соединение для чтения (WAL-режим
+ * позволяет читать параллельно с записью) и свой мьютекс записи, поэтому регистрации
+ * и логины разных пользователей масштабируются с количеством шардов.
+ *
+ * Пакетные операции группируются по шардам: одна транзакция на каждый затронутый шард.
+ * При одном шарде используется ровно указанный файл, что совместимо с прежним `users.db`.
+ */
+class SqliteStore : public UserStore, public RevocationStore {
+public:
+    SqliteStore() = default;
+    ~SqliteStore() override;
+
+    SqliteStore(const SqliteStore&) = delete;
+    SqliteStore& operator=(const SqliteStore&) = delete;
+
+    /**
+     * @brief Открывает базу из одного файла (один шард).
+     */
+    bool open(const std::string& db_path);
+
+    /**
+     * @brief Открывает шарды и при необходимости создаёт таблицы и индексы.
+     *
+     * @param shard_paths Пути к файлам шардов; порядок определяет номер шарда.
+     * @return true при успехе; false при ошибке открытия или создания схемы.
+     */
+    bool open(const std::vector<std::string>& shard_paths);
+
+    /**
+     * @brief Формирует имена файлов шардов: `users.db` → `users.shard0.db`, `users.shard1.db`, ...
+     *
+     * При count == 1 возвращается сам basePath.
+     */
+    static std::vector<std::string> shardPaths(const std::string& basePath, size_t count);
+
+    /**
+     * @brief Номер шарда для ключа (имени пользователя или токена).
+     */
+    static size_t shardIndex(const std::string& key, size_t shardCount);
+
+    /**
+     * @brief Перераспределяет существующую базу по новому количеству шардов (офлайн).
+     *
+     * Переносит всех пользователей с их хешами паролей и ещё не истёкшие токены blacklist.
+     * Сервер на время перешардирования должен быть остановлен. Исходные шарды открываются
+     * только на чтение и не изменяются; если хотя бы одного из них нет, перенос не начинается.
+     *
+     * @param srcBase Базовый путь исходной базы.
+     * @param srcShards Количество исходных шардов.
+     * @param dstBase Базовый путь новой базы (файлы не должны пересекаться с исходными).
+     * @param dstShards Новое количество шардов.
+     * @return true, если все записи перенесены.
+     */
+    static bool reshard(const std::string& srcBase, size_t srcShards,
+                        const std::string& dstBase, size_t dstShards);
+
+    size_t shardCount() const { return shards.size(); }
+
+    bool insertUser(const std::string& username, const std::string& passwordHash) override;
+    LookupResult findUser(const std::string& username, User& user_out) override;
+
+    bool blacklistToken(const std::string& token, uint64_t expires_at) override;
+    bool isTokenBlacklisted(const std::string& token) override;
+    bool findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked) override;
+    int purgeExpired(int batchSize, uint64_t now) override;
+
+    bool applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) override;
+
+private:
+    /**
+     * @brief Один шард: отдельный файл, соединения и блокировка записи.
+     */
+    struct Shard {
+        sqlite3* writer = nullptr;  ///< Соединение для записи.
+        sqlite3* reader = nullptr;  ///< Соединение для чтения.
+        std::mutex write_mutex;     ///< Сериализует запись в этот шард.
+    };
+
+    Shard& shardFor(const std::string& key);
+    bool applyShardBatch(Shard& shard, const std::vector<const WriteOp*>& ops, std::vector<bool>& results);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<size_t> purge_cursor{0};  ///< С какого шарда начинать следующую порцию очистки.
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include "extern/httplib.h"
+
+#include <string>
+
+/**
+ * @brief Фиксированные ответы API: тело и заголовки не зависят от запроса.
+ */
+enum class StaticResponseId {
+    Preflight,                   ///< 200 на CORS preflight (OPTIONS).
+    UserRegistered,              ///< 201 "User registered successfully".
+    LoggedOut,                   ///< 200 "Logged out successfully".
+    MissingCredentials,          ///< 400 "Missing 'username' or 'password'".
+    MissingAuthorization,        ///< 400 "Missing Authorization header" (/refresh, /logout).
+    InvalidAuthorization,        ///< 400 "Invalid Authorization header format" (/refresh, /logout).
+    InvalidAccessAuthorization,  ///< 400 "Invalid Authorization format" (/secure/data).
+    MissingAccessAuthorization,  ///< 401 "Missing 'Authorization' header" (/secure/data).
+    InvalidCredentials,          ///< 401 "Invalid credentials".
+    InvalidAccessToken,          ///< 401 "Invalid or expired access token".
+    InvalidRefreshToken,         ///< 401 "Invalid or expired refresh token".
+    RefreshTokenBlacklisted,     ///< 403 "Refresh token is blacklisted".
+    InvalidIntrospectRequest,    ///< 400 "Expected {\"tokens\": [...]}" (/introspect).
+    TooManyTokens,               ///< 413 "Too many tokens" (/introspect).
+    UserExists,                  ///< 409 "Username already exists".
+    KeyError,                    ///< 500 "Key error".
+    DatabaseError,               ///< 500 "Database error".
+    ServerBusy,                  ///< 503 с Retry-After: 1.
+    BadRequest,                  ///< 400 без тела (ошибка разбора запроса).
+    NotFound,                    ///< 404 без тела.
+    LengthRequired,              ///< 411 без тела (chunked-тело запроса).
+    PayloadTooLarge,             ///< 413 без тела.
+    HeadersTooLarge,             ///< 431 без тела.
+    InternalError,               ///< 500 без тела (исключение в обработчике).
+    VersionNotSupported,         ///< 505 без тела.
+    Count
+};
+
+/**
+ * @brief Неизменяемый шаблон ответа, сериализованный заранее.
+ */
+struct StaticResponse {
+    int status = 0;
+    std::string body;
+    std::string contentType;
+    httplib::Headers headers;        ///< Заголовки сверх StaticResponses::commonHeaders().
+    std::string keepAliveWire;       ///< Ответ целиком (строка статуса, заголовки, тело), Connection: keep-alive.
+    std::string closeWire;           ///< То же с Connection: close.
+
+    /// Готовые байты ответа.
+    const std::string& wire(bool keepAlive) const { return keepAlive ? keepAliveWire : closeWire; }
+};
+
+/**
+ * @brief Таблица фиксированных ответов.
+ *
+ * Отказы (просроченный токен, нет заголовка, неверный пароль) и CORS preflight
+ * составляют основную массу ответов при атаке или неправильно настроенном клиенте.
+ * Их строка статуса, заголовки и тело одинаковы для всех запросов, поэтому
+ * сериализуются один раз при запуске (prepare()) в двух вариантах — keep-alive и close:
+ * - EpollServer/UringServer дописывают готовые байты в буфер соединения одним копированием;
+ * - httplib получает готовый набор заголовков и тело через apply().
+ *
+ * Обработчик маршрута возвращает указатель на шаблон вместо заполнения Response.
+ */
+class StaticResponses {
+public:
+    /**
+     * @brief Строит и сериализует все шаблоны; вызывается из HttpServer::start().
+     */
+    static void prepare();
+
+    /**
+     * @brief Шаблон по идентификатору.
+     */
+    static const StaticResponse& get(StaticResponseId id);
+
+    /**
+     * @brief Шаблон без тела для кода ошибки разбора запроса (400, 404, 411, 413, 431, 500, 505).
+     *
+     * Неизвестный код отображается в 400.
+     */
+    static const StaticResponse& forStatus(int status);
+
+    /**
+     * @brief Заголовки, которые движки добавляют к каждому ответу (CORS).
+     */
+    static const httplib::Headers& commonHeaders();
+
+    /**
+     * @brief Строит шаблон и сериализует его в обоих вариантах (keep-alive и close).
+     *
+     * Единственное место, где шаблоны собираются из httplib::Response; им пользуются
+     * и ответы, которые готовятся вне этой таблицы (JWKS, 429 RateLimiter).
+     *
+     * @param status Код ответа.
+     * @param body Тело; пустое — ответ без тела.
+     * @param contentType Тип тела.
+     * @param headers Заголовки сверх commonHeaders().
+     */
+    static StaticResponse make(int status, const std::string& body, const std::string& contentType,
+                               const httplib::Headers& headers);
+
+    /**
+     * @brief Заполняет Response движка httplib из шаблона (общие заголовки httplib добавляет сам).
+     */
+    static void apply(const StaticResponse& response, httplib::Response& res);
+};
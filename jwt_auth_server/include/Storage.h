@@ -0,0 +1,113 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Структура, представляющая пользователя из базы данных.
+ */
+struct User {
+    int id;                     ///< Уникальный идентификатор пользователя в таблице.
+    std::string username;       ///< Имя пользователя.
+    std::string password;       ///< Хеш пароля (уже захеширован).
+};
+
+/**
+ * @brief Одна операция записи для пакетного применения через Database::applyBatch().
+ */
+struct WriteOp {
+    /**
+     * @brief Вид операции записи.
+     */
+    enum class Type {
+        InsertUser,      ///< Вставка пользователя: key — имя, value — хеш пароля.
+        UpdatePassword,  ///< Замена хеша пароля существующего пользователя: key — имя, value — новый хеш.
+        BlacklistToken   ///< Блокировка токена: key — токен, expiresAt — время истечения.
+    };
+
+    Type type;                ///< Вид операции.
+    std::string key;          ///< Имя пользователя или токен.
+    std::string value;        ///< Хеш пароля (только для InsertUser и UpdatePassword).
+    uint64_t expiresAt = 0;   ///< Время истечения токена (только для BlacklistToken).
+};
+
+/**
+ * @brief Результат поиска записи в хранилище.
+ */
+enum class LookupResult {
+    Found,     ///< Запись найдена.
+    NotFound,  ///< Записи нет.
+    Error      ///< Ошибка хранилища — результат неизвестен.
+};
+
+/**
+ * @brief Абстрактное хранилище пользователей.
+ *
+ * Реализации обязаны быть потокобезопасными: методы вызываются
+ * одновременно из обработчиков HTTP и из потока WriteQueue.
+ */
+class UserStore {
+public:
+    virtual ~UserStore() = default;
+
+    /**
+     * @brief Добавляет пользователя с уже вычисленным хешем пароля.
+     * @return true, если пользователь добавлен; false, если имя занято или произошла ошибка.
+     */
+    virtual bool insertUser(const std::string& username, const std::string& passwordHash) = 0;
+
+    /**
+     * @brief Ищет пользователя по имени.
+     */
+    virtual LookupResult findUser(const std::string& username, User& user_out) = 0;
+
+    /**
+     * @brief Применяет пакет операций одной фиксацией.
+     *
+     * Реализация обрабатывает только операции своего типа. Если один объект
+     * реализует и UserStore, и RevocationStore, Database передаёт ему весь пакет целиком.
+     *
+     * @param ops Операции записи.
+     * @param[out] results Результат каждой операции.
+     * @return true, если пакет зафиксирован.
+     */
+    virtual bool applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) = 0;
+};
+
+/**
+ * @brief Абстрактное хранилище отозванных токенов (blacklist).
+ */
+class RevocationStore {
+public:
+    virtual ~RevocationStore() = default;
+
+    /**
+     * @brief Отзывает токен до момента expires_at.
+     */
+    virtual bool blacklistToken(const std::string& token, uint64_t expires_at) = 0;
+
+    /**
+     * @brief Проверяет, отозван ли токен.
+     */
+    virtual bool isTokenBlacklisted(const std::string& token) = 0;
+
+    /**
+     * @brief Проверяет пакет токенов за один проход по хранилищу.
+     *
+     * @param tokens Проверяемые токены.
+     * @param[out] revoked revoked[i] — отозван ли tokens[i].
+     * @return false при ошибке хранилища (revoked тогда не определён).
+     */
+    virtual bool findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked) = 0;
+
+    /**
+     * @brief Удаляет не более batchSize токенов с expires_at < now.
+     * @return Количество удалённых записей или -1 при ошибке.
+     */
+    virtual int purgeExpired(int batchSize, uint64_t now) = 0;
+
+    /**
+     * @brief См. UserStore::applyBatch().
+     */
+    virtual bool applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+/**
+ * @brief Счётчики кэша проверенных токенов.
+ */
+struct TokenCacheStats {
+    uint64_t hits = 0;       ///< Токен найден — проверка подписи не потребовалась.
+    uint64_t misses = 0;     ///< Токена нет в кэше.
+    uint64_t expired = 0;    ///< Запись найдена, но срок токена уже истёк.
+    uint64_t evictions = 0;  ///< Вытеснено записей по LRU.
+};
+
+/**
+ * @brief Ограниченный шардированный LRU-кэш уже проверенных access токенов.
+ *
+ * Клиент обычно предъявляет один и тот же access токен много раз за время его жизни,
+ * а каждая полная проверка — это Base64, SHA-256 и RSA `modPow`. Кэш хранит
+ * результат успешной проверки (subject и `exp`) под ключом SHA-256 всего токена,
+ * поэтому повторная проверка стоит одного хеша и поиска в таблице.
+ *
+ * Запись живёт не дольше самого токена: при обращении после `exp` она удаляется.
+ * Ключ — хеш полной строки токена, включая подпись, поэтому изменённый токен
+ * в кэш не попадает и проходит полную проверку.
+ *
+ * Кэш разбит на шарды по первым байтам ключа, у каждого шарда свой мьютекс.
+ */
+class TokenCache {
+public:
+    /**
+     * @brief Задаёт размер кэша и очищает его.
+     *
+     * @param capacity Максимальное число токенов (0 — кэш отключён).
+     * @param shards Количество шардов.
+     */
+    static void configure(size_t capacity, size_t shards);
+
+    /**
+     * @brief Ищет ранее проверенный токен.
+     *
+     * @param token Токен целиком.
+     * @param now Текущее время (UNIX).
+     * @param[out] outSubject Subject токена.
+     * @param[out] outExpiresAt Время истечения токена.
+     * @return true, если токен проверялся ранее и ещё не истёк.
+     */
+    static bool lookup(std::string_view token, uint64_t now, std::string& outSubject, uint64_t& outExpiresAt);
+
+    /**
+     * @brief Запоминает успешно проверенный токен до момента expiresAt.
+     */
+    static void put(std::string_view token, const std::string& subject, uint64_t expiresAt);
+
+    /**
+     * @brief Удаляет все записи (например, при смене ключей подписи).
+     */
+    static void clear();
+
+    /**
+     * @brief Возвращает снимок счётчиков.
+     */
+    static TokenCacheStats getStats();
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "RSA.h"
+
+/**
+ * @brief Вид токена.
+ */
+enum class TokenKind {
+    Access,   ///< Короткоживущий токен доступа.
+    Refresh   ///< Долгоживущий токен обновления.
+};
+
+/**
+ * @brief Алгоритм подписи токена.
+ */
+enum class SignatureAlgorithm {
+    RS256     ///< RSA + SHA-256.
+};
+
+/**
+ * @brief Свойства вида токена, известные на этапе компиляции.
+ */
+template <TokenKind Kind>
+struct TokenTraits;
+
+template <>
+struct TokenTraits<TokenKind::Access> {
+    static constexpr std::string_view typ = "access";   ///< Значение claim `typ`.
+    static constexpr const char* name = "Access";       ///< Имя для логов.
+};
+
+template <>
+struct TokenTraits<TokenKind::Refresh> {
+    static constexpr std::string_view typ = "refresh";
+    static constexpr const char* name = "Refresh";
+};
+
+/**
+ * @brief Свойства алгоритма подписи, известные на этапе компиляции.
+ */
+template <SignatureAlgorithm Algorithm>
+struct AlgorithmTraits;
+
+template <>
+struct AlgorithmTraits<SignatureAlgorithm::RS256> {
+    static constexpr std::string_view header = R"({"alg":"RS256","typ":"JWT"})";  ///< JSON заголовка.
+    using PrivateKey = RSAPrivateKey;
+    using PublicKey = RSAPublicKey;
+};
+
+/**
+ * @brief Единый кодек JWT, специализированный видом токена и алгоритмом подписи.
+ *
+ * Все различия между access и refresh токенами (значение `typ`, имена в логах)
+ * задаются TokenTraits и подставляются при компиляции, поэтому выпуск и проверка
+ * любого вида токена проходят по одному и тому же коду.
+ *
+ * Payload всегда начинается с `{"typ":"<вид>",`. Благодаря этому вид токена
+ * проверяется сравнением фиксированного префикса закодированного payload
+ * с константой, вычисленной при компиляции, — ещё до декодирования и проверки подписи.
+ * Заголовок проверяется так же, целиком.
+ *
+ * Токены старого формата (`typ` в конце payload) по-прежнему принимаются:
+ * для них вид токена проверяется по разобранным claims.
+ *
+ * Реализация и явные инстанцирования — в TokenCodec.cpp.
+ *
+ * @tparam Kind Вид токена.
+ * @tparam Algorithm Алгоритм подписи.
+ */
+template <TokenKind Kind, SignatureAlgorithm Algorithm = SignatureAlgorithm::RS256>
+class TokenCodec {
+public:
+    using Traits = TokenTraits<Kind>;
+    using PrivateKey = typename AlgorithmTraits<Algorithm>::PrivateKey;
+    using PublicKey = typename AlgorithmTraits<Algorithm>::PublicKey;
+
+    /**
+     * @brief Выпускает подписанный токен.
+     *
+     * @param subject Имя пользователя (claim `sub`).
+     * @param expirationSeconds Время жизни токена в секундах.
+     * @param privKey Приватный ключ подписи.
+     * @return Токен `header.payload.signature`.
+     */
+    static std::string create(const std::string& subject, uint64_t expirationSeconds, const PrivateKey& privKey);
+
+    /**
+     * @brief Верхняя граница длины `header.payload` для subject заданной длины.
+     *
+     * @param escapedSubjectLen Длина subject после Json::escape().
+     */
+    static size_t signingInputCapacity(size_t escapedSubjectLen);
+
+    /**
+     * @brief Дописывает в out подписываемую часть токена `header.payload`.
+     *
+     * @param out Буфер (обычно заранее выделенный через signingInputCapacity()).
+     * @param escapedSubject Subject, уже экранированный Json::escape().
+     * @param issuedAt Claim `iat`.
+     * @param expiresAt Claim `exp`.
+     */
+    static void appendSigningInput(std::string& out, std::string_view escapedSubject,
+                                   uint64_t issuedAt, uint64_t expiresAt);
+
+    /**
+     * @brief Подписывает `header.payload` и возвращает готовый токен.
+     *
+     * Не обращается к общему состоянию, поэтому разные токены можно подписывать параллельно.
+     */
+    static std::string sign(std::string_view signingInput, const PrivateKey& privKey);
+
+    /**
+     * @brief Проверяет заголовок, вид, подпись и срок действия токена.
+     *
+     * @param token Токен.
+     * @param pubKey Открытый ключ.
+     * @param[out] outSubject Claim `sub`.
+     * @param[out] outExpiresAt Claim `exp`.
+     * @return true, если токен валиден.
+     */
+    static bool verify(std::string_view token, const PublicKey& pubKey,
+                       std::string& outSubject, uint64_t& outExpiresAt);
+};
+
+using AccessTokenCodec = TokenCodec<TokenKind::Access>;    ///< Кодек access токенов RS256.
+using RefreshTokenCodec = TokenCodec<TokenKind::Refresh>;  ///< Кодек refresh токенов RS256.
@@ -0,0 +1,53 @@
+#pragma once
+#include "ServerConfig.h"
+
+#include <chrono>
+
+/**
+ * @brief HTTP/1.1 сервер на io_uring: по одному кольцу и циклу на ядро.
+ *
+ * Устроен как EpollServer (слушающий сокет с `SO_REUSEPORT` и закреплённый
+ * поток на каждое ядро, общий разбор запросов в HttpProtocol), но вместо
+ * уведомлений о готовности и отдельных read/send использует асинхронные
+ * операции io_uring, отправляемые пачкой одним io_uring_enter за итерацию:
+ * - multishot accept — одна заявка принимает все входящие соединения;
+ * - multishot recv с provided buffer ring — ядро само берёт буфер из общего
+ *   для цикла кольца, а не держит по буферу на каждое простаивающее соединение;
+ * - последний ответ соединения отправляется цепочкой send → shutdown → close
+ *   (IOSQE_IO_LINK), без лишнего круга через цикл.
+ *
+ * Блокирующие маршруты, как и в EpollServer, выполняются в пуле потоков;
+ * готовый ответ возвращается в цикл через eventfd, чтение которого тоже стоит
+ * в кольце.
+ *
+ * Нужно ядро 6.0+ (multishot recv, buffer ring). Если io_uring недоступен
+ * (старое ядро, seccomp, io_uring_disabled), run() пишет об этом в лог
+ * и запускает EpollServer.
+ *
+ * Плавная остановка (drain()) устроена как в EpollServer: multishot accept
+ * отменяется, очередь слушающего сокета принимается, сокет закрывается.
+ *
+ * Кольца создаются системными вызовами напрямую, liburing не требуется.
+ */
+class UringServer {
+public:
+    /**
+     * @brief Запускает циклы и блокируется до вызова stop().
+     *
+     * @param settings Адрес, число циклов, размер пула, keep-alive, таймауты и лимиты.
+     * @return false, если не удалось открыть слушающие сокеты.
+     */
+    static bool run(const HttpSettings& settings);
+
+    /**
+     * @brief Останавливает все циклы; run() возвращается после их завершения.
+     */
+    static void stop();
+
+    /**
+     * @brief Плавная остановка: run() возвращается, когда начатые запросы выполнены и отправлены.
+     *
+     * Соединения, не закрывшиеся за timeout, обрываются. Можно вызвать до run().
+     */
+    static void drain(std::chrono::seconds timeout);
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include "Database.h"
+
+/**
+ * @brief Счётчики кэша пользователей (для подбора размеров кэша).
+ */
+struct UserCacheStats {
+    uint64_t hits = 0;           ///< Найдено в кэше существующих пользователей.
+    uint64_t negativeHits = 0;   ///< Найдено в негативном кэше (пользователь не существует).
+    uint64_t misses = 0;         ///< Промахи — потребовался запрос к базе.
+    uint64_t evictions = 0;      ///< Вытеснено записей по LRU.
+    uint64_t invalidations = 0;  ///< Явных инвалидаций (регистрация, смена пароля).
+};
+
+/**
+ * @brief Ограниченный шардированный LRU-кэш записей User перед Database::getUser().
+ *
+ * Кэш разбит на шарды по хешу имени пользователя; у каждого шарда свой мьютекс
+ * и свой LRU-список, поэтому параллельные логины разных пользователей не конкурируют.
+ *
+ * Помимо найденных пользователей кэш хранит короткоживущие негативные записи
+ * для несуществующих имён, чтобы перебор несуществующих логинов не нагружал базу.
+ * Негативные записи имеют отдельный лимит и не вытесняют «горячих» пользователей.
+ *
+ * Любое изменение пользователя (регистрация, смена пароля) обязано вызвать invalidate().
+ * Каждая инвалидация увеличивает поколение шарда, и запись, прочитанная из базы
+ * до инвалидации, в кэш уже не попадёт.
+ */
+class UserCache {
+public:
+    /**
+     * @brief Результат поиска в кэше.
+     */
+    enum class Lookup {
+        Miss,        ///< Записи нет — нужно обратиться к базе.
+        Hit,         ///< Пользователь найден в кэше.
+        KnownMissing ///< Недавно проверено: такого пользователя нет.
+    };
+
+    /**
+     * @brief Задаёт параметры кэша и очищает его содержимое.
+     *
+     * @param capacity Максимальное количество пользователей в кэше (0 — кэш отключён).
+     * @param shards Количество шардов.
+     * @param negativeCapacity Максимальное количество негативных записей.
+     * @param negativeTtl Время жизни негативной записи.
+     */
+    static void configure(size_t capacity, size_t shards,
+                          size_t negativeCapacity, std::chrono::milliseconds negativeTtl);
+
+    /**
+     * @brief Ищет пользователя в кэше.
+     *
+     * @param username Имя пользователя.
+     * @param[out] user_out Данные пользователя при результате Hit.
+     * @param[out] generation Поколение шарда; передаётся в put()/putMissing() после чтения из базы.
+     */
+    static Lookup lookup(const std::string& username, User& user_out, uint64_t& generation);
+
+    /**
+     * @brief Кладёт пользователя в кэш, если шард не инвалидировался после lookup().
+     */
+    static void put(const User& user, uint64_t generation);
+
+    /**
+     * @brief Запоминает, что пользователя нет, если шард не инвалидировался после lookup().
+     */
+    static void putMissing(const std::string& username, uint64_t generation);
+
+    /**
+     * @brief Удаляет пользователя (и негативную запись о нём) из кэша.
+     */
+    static void invalidate(const std::string& username);
+
+    /**
+     * @brief Возвращает снимок счётчиков.
+     */
+    static UserCacheStats getStats();
+};
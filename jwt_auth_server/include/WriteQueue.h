@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <future>
+
+/**
+ * @brief Статистика очереди групповой записи.
+ */
+struct WriteQueueStats {
+    uint64_t enqueued = 0;        ///< Всего поставлено операций в очередь.
+    uint64_t batches = 0;         ///< Количество зафиксированных (или неудачных) транзакций.
+    uint64_t failedBatches = 0;   ///< Транзакции, завершившиеся ошибкой COMMIT.
+    uint64_t largestBatch = 0;    ///< Максимальный размер пакета.
+    uint64_t commitMicros = 0;    ///< Суммарное время применения пакетов (мкс).
+};
+
+/**
+ * @brief Очередь отложенной записи с групповой фиксацией (group commit).
+ *
+ * Обработчики HTTP-запросов ставят операции записи (регистрация, logout, перехеширование пароля) в очередь
+ * и получают std::future<bool>. Единственный поток-писатель забирает операции
+ * пакетами и применяет их одной транзакцией через Database::applyBatch().
+ *
+ * Пакет закрывается, когда:
+ * - набрано maxBatchSize операций, либо
+ * - с момента поступления первой операции пакета прошло maxDelay.
+ *
+ * Future каждой операции завершается только после фиксации транзакции,
+ * поэтому ответ клиенту отправляется, когда запись уже надёжно сохранена.
+ * Пропускная способность записи таким образом растёт с размером пакета,
+ * а не ограничивается задержкой синхронизации диска.
+ *
+ * Если очередь не запущена, операции выполняются синхронно в вызывающем потоке.
+ */
+class WriteQueue {
+public:
+    /**
+     * @brief Запускает поток-писатель.
+     *
+     * @param maxBatchSize Максимальное количество операций в одной транзакции.
+     * @param maxDelay Максимальное время ожидания наполнения пакета.
+     */
+    static void start(size_t maxBatchSize = 64,
+                      std::chrono::microseconds maxDelay = std::chrono::milliseconds(2));
+
+    /**
+     * @brief Останавливает поток-писатель, предварительно применив все операции из очереди.
+     */
+    static void stop();
+
+    /**
+     * @brief Ставит в очередь добавление пользователя.
+     *
+     * @param username Имя пользователя.
+     * @param passwordHash Уже вычисленный хеш пароля.
+     * @return Future, который получит true после фиксации или false, если пользователь уже существует.
+     */
+    static std::future<bool> addUser(const std::string& username, const std::string& passwordHash);
+
+    /**
+     * @brief Ставит в очередь замену хеша пароля существующего пользователя.
+     *
+     * @param username Имя пользователя.
+     * @param passwordHash Новый хеш пароля.
+     * @return Future, который получит true после фиксации или false, если пользователя нет.
+     */
+    static std::future<bool> updatePassword(const std::string& username, const std::string& passwordHash);
+
+    /**
+     * @brief Ставит в очередь блокировку токена.
+     *
+     * @param token JWT токен.
+     * @param expires_at Время истечения токена (UNIX-время).
+     * @return Future, который получит true после фиксации записи.
+     */
+    static std::future<bool> blacklistToken(const std::string& token, uint64_t expires_at);
+
+    /**
+     * @brief Возвращает снимок статистики очереди.
+     */
+    static WriteQueueStats getStats();
+};
@@ -0,0 +1,87 @@
+#include "../include/AuthMiddleware.h"
+#include "../include/Jwks.h"
+#include "../include/KeyStorage.h"
+#include "../include/JwtView.h"
+#include "../include/TokenCodec.h"
+
+#include <iostream>
+
+namespace {
+    RSAPublicKey publicKey;
+    RSAPrivateKey privateKey;
+    bool keysLoaded = false;
+
+    /**
+     * @brief Отказы для одного вида токена.
+     */
+    struct Rejections {
+        StaticResponseId missingHeader;
+        StaticResponseId badFormat;
+        StaticResponseId invalidToken;
+    };
+
+    const Rejections ACCESS_REJECTIONS = {StaticResponseId::MissingAccessAuthorization,
+                                          StaticResponseId::InvalidAccessAuthorization,
+                                          StaticResponseId::InvalidAccessToken};
+
+    const Rejections REFRESH_REJECTIONS = {StaticResponseId::MissingAuthorization,
+                                           StaticResponseId::InvalidAuthorization,
+                                           StaticResponseId::InvalidRefreshToken};
+
+    const StaticResponse* reject(StaticResponseId id, const httplib::Request& req, const char* reason) {
+        std::cerr << "[AUTH] " << req.method << " " << req.path << ": " << reason << std::endl;
+        return &StaticResponses::get(id);
+    }
+
+    /**
+     * @brief Извлекает и проверяет токен вида Kind.
+     */
+    template <TokenKind Kind>
+    const StaticResponse* verify(const httplib::Request& req, const Rejections& rejections, AuthContext& auth) {
+        auto header = req.headers.find("Authorization");
+        if (header == req.headers.end())
+            return reject(rejections.missingHeader, req, "нет заголовка Authorization");
+
+        if (!JwtView::bearerToken(header->second, auth.token))
+            return reject(rejections.badFormat, req, "заголовок Authorization должен начинаться с 'Bearer '");
+
+        if (!keysLoaded)
+            return reject(StaticResponseId::KeyError, req, "ключи не загружены");
+
+        if (!TokenCodec<Kind>::verify(auth.token, publicKey, auth.subject, auth.expiresAt))
+            return reject(rejections.invalidToken, req, "токен недействителен или просрочен");
+
+        return nullptr;
+    }
+}
+
+bool AuthMiddleware::configure() {
+    keysLoaded = KeyStorage::loadKeys(publicKey, privateKey);
+    if (!keysLoaded) {
+        std::cerr << "[AUTH] Не удалось загрузить ключи: маршруты с токенами будут отвечать 500" << std::endl;
+        return false;
+    }
+    Jwks::publish(publicKey);
+    return true;
+}
+
+const StaticResponse* AuthMiddleware::authenticate(AuthRequirement requirement, const httplib::Request& req,
+                                                   AuthContext& auth) {
+    switch (requirement) {
+        case AuthRequirement::AccessToken:
+            return verify<TokenKind::Access>(req, ACCESS_REJECTIONS, auth);
+        case AuthRequirement::RefreshToken:
+            return verify<TokenKind::Refresh>(req, REFRESH_REJECTIONS, auth);
+        case AuthRequirement::None:
+            break;
+    }
+    return nullptr;
+}
+
+const RSAPrivateKey* AuthMiddleware::signingKey() {
+    return keysLoaded ? &privateKey : nullptr;
+}
+
+const RSAPublicKey* AuthMiddleware::verificationKey() {
+    return keysLoaded ? &publicKey : nullptr;
+}
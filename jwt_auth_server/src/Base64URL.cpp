@@ -1,7 +1,9 @@
 #include "../include/Base64URL.h"
+#include "../include/Metrics.h"
 #include <string>
 #include <vector>
 #include <iostream>
+#include <cstdint>
 
 static const char* base64_chars =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
@@ -9,6 +11,7 @@ static const char* base64_chars =
     "0123456789+/";
 
 std::string Base64URL::encode(const std::string& input) {
+    StageTimer timer(MetricStage::Base64Encode);
     std::cout << "[Base64URL::encode] Входная строка: " << input << std::endl;
 
     std::string encoded;
@@ -41,7 +44,76 @@ std::string Base64URL::encode(const std::string& input) {
     return encoded;
 }
 
+namespace {
+    /**
+     * @brief Таблица обратного преобразования символа Base64URL в 6-битное значение (-1 — недопустимый символ).
+     */
+    struct DecodeTable {
+        signed char value[256];
+
+        DecodeTable() {
+            for (int i = 0; i < 256; ++i) value[i] = -1;
+            for (int i = 0; i < 62; ++i) value[static_cast<unsigned char>(base64_chars[i])] = static_cast<signed char>(i);
+            value[static_cast<unsigned char>('-')] = 62;
+            value[static_cast<unsigned char>('_')] = 63;
+        }
+    };
+
+    const DecodeTable decode_table;
+}
+
+size_t Base64URL::encodedSize(size_t inputLen) {
+    return inputLen / 3 * 4 + (inputLen % 3 == 0 ? 0 : inputLen % 3 + 1);
+}
+
+void Base64URL::encode(std::string_view input, std::string& out) {
+    StageTimer timer(MetricStage::Base64Encode);
+    static const char* url_chars =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "abcdefghijklmnopqrstuvwxyz"
+        "0123456789-_";
+
+    out.reserve(out.size() + encodedSize(input.size()));
+    uint32_t val = 0;
+    int valb = -6;
+    for (unsigned char c : input) {
+        val = (val << 8) | c;
+        valb += 8;
+        while (valb >= 0) {
+            out.push_back(url_chars[(val >> valb) & 0x3F]);
+            valb -= 6;
+        }
+    }
+    if (valb > -6) out.push_back(url_chars[((val << 8) >> (valb + 8)) & 0x3F]);
+}
+
+size_t Base64URL::decodedSize(size_t encodedLen) {
+    return encodedLen / 4 * 3 + (encodedLen % 4 == 0 ? 0 : encodedLen % 4 - 1);
+}
+
+bool Base64URL::decode(std::string_view input, char* out, size_t capacity, size_t& outLen) {
+    StageTimer timer(MetricStage::Base64Decode);
+    outLen = 0;
+    if (input.size() % 4 == 1) return false;
+    if (decodedSize(input.size()) > capacity) return false;
+
+    uint32_t val = 0;
+    int valb = -8;
+    for (unsigned char c : input) {
+        int v = decode_table.value[c];
+        if (v < 0) return false;
+        val = (val << 6) | static_cast<uint32_t>(v);
+        valb += 6;
+        if (valb >= 0) {
+            out[outLen++] = static_cast<char>((val >> valb) & 0xFF);
+            valb -= 8;
+        }
+    }
+    return true;
+}
+
 std::string Base64URL::decode(const std::string& input) {
+    StageTimer timer(MetricStage::Base64Decode);
     std::cout << "[Base64URL::decode] Входная строка (Base64URL): " << input << std::endl;
 
     std::string b64 = input;
@@ -27,12 +27,12 @@ BigInt::BigInt(const std::string& str) {
     trim();
 }
 
-BigInt::BigInt(const std::string& str, int base) {
+BigInt::BigInt(std::string_view str, int base) {
     if (base != 10 && base != 16) {
         throw std::invalid_argument("Unsupported base");
     }
 
-    std::string s = str;
+    std::string s(str);
     negative = false;
 
     if (!s.empty() && s[0] == '-') {
@@ -106,6 +106,22 @@ std::string BigInt::toString(int base) const {
     return result;
 }
 
+bool BigInt::toBytes(uint8_t* out, size_t len) const {
+    if (negative && !isZero()) return false;
+
+    std::fill(out, out + len, 0);
+    for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
+        unsigned carry = static_cast<unsigned>(*it);
+        for (size_t i = len; i-- > 0;) {
+            unsigned v = out[i] * 10u + carry;
+            out[i] = static_cast<uint8_t>(v & 0xFF);
+            carry = v >> 8;
+        }
+        if (carry != 0) return false;
+    }
+    return true;
+}
+
 void BigInt::trim() {
     while (digits.size() > 1 && digits.back() == 0)
         digits.pop_back();
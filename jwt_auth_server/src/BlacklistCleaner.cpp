@@ -0,0 +1,119 @@
+#include "../include/BlacklistCleaner.h"
+#include "../include/Database.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    std::thread worker;
+    std::mutex state_mutex;
+    std::condition_variable wakeup;
+    bool running = false;
+    bool stop_requested = false;
+
+    std::atomic<uint64_t> stat_runs{0};
+    std::atomic<uint64_t> stat_batches{0};
+    std::atomic<uint64_t> stat_rows{0};
+    std::atomic<uint64_t> stat_errors{0};
+    std::atomic<uint64_t> stat_total_us{0};
+    std::atomic<uint64_t> stat_last_run_us{0};
+    std::atomic<uint64_t> stat_max_batch_us{0};
+
+    uint64_t elapsedMicros(std::chrono::steady_clock::time_point since) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - since).count());
+    }
+
+    /**
+     * @brief Ждёт указанное время; возвращает false, если за это время был вызван stop().
+     */
+    template <typename Duration>
+    bool sleepUnlessStopped(Duration d) {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        return !wakeup.wait_for(lock, d, [] { return stop_requested; });
+    }
+}
+
+void BlacklistCleaner::start(std::chrono::seconds interval, int batchSize, std::chrono::milliseconds batchPause) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    if (running) return;
+    running = true;
+    stop_requested = false;
+
+    std::cout << "[BlacklistCleaner] Запуск: интервал " << interval.count()
+              << " с, порция " << batchSize << " строк" << std::endl;
+
+    worker = std::thread([interval, batchSize, batchPause] {
+        while (sleepUnlessStopped(interval)) {
+            runOnce(batchSize, batchPause);
+        }
+    });
+}
+
+void BlacklistCleaner::stop() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (!running) return;
+        stop_requested = true;
+    }
+    wakeup.notify_all();
+    if (worker.joinable()) worker.join();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        running = false;
+    }
+    std::cout << "[BlacklistCleaner] Остановлен" << std::endl;
+}
+
+void BlacklistCleaner::runOnce(int batchSize, std::chrono::milliseconds batchPause) {
+    auto runStart = std::chrono::steady_clock::now();
+    uint64_t now = static_cast<uint64_t>(std::time(nullptr));
+    uint64_t purged = 0;
+
+    while (true) {
+        auto batchStart = std::chrono::steady_clock::now();
+        int deleted = Database::purgeExpiredBlacklist(batchSize, now);
+        uint64_t batchUs = elapsedMicros(batchStart);
+
+        stat_batches++;
+        uint64_t prevMax = stat_max_batch_us.load();
+        while (batchUs > prevMax && !stat_max_batch_us.compare_exchange_weak(prevMax, batchUs)) {}
+
+        if (deleted < 0) {
+            stat_errors++;
+            std::cerr << "[BlacklistCleaner] Ошибка при удалении истёкших токенов" << std::endl;
+            break;
+        }
+
+        purged += static_cast<uint64_t>(deleted);
+        if (deleted < batchSize) break;
+        if (!sleepUnlessStopped(batchPause)) break;
+    }
+
+    uint64_t runUs = elapsedMicros(runStart);
+    stat_runs++;
+    stat_rows += purged;
+    stat_total_us += runUs;
+    stat_last_run_us = runUs;
+
+    if (purged > 0) {
+        std::cout << "[BlacklistCleaner] Удалено истёкших токенов: " << purged
+                  << " за " << runUs << " мкс" << std::endl;
+    }
+}
+
+BlacklistCleanerStats BlacklistCleaner::getStats() {
+    BlacklistCleanerStats stats;
+    stats.runs = stat_runs.load();
+    stats.batches = stat_batches.load();
+    stats.rowsPurged = stat_rows.load();
+    stats.errors = stat_errors.load();
+    stats.totalMicros = stat_total_us.load();
+    stats.lastRunMicros = stat_last_run_us.load();
+    stats.maxBatchMicros = stat_max_batch_us.load();
+    return stats;
+}
@@ -0,0 +1,20 @@
+#include "../include/ConstantTime.h"
+
+#include <cstdint>
+
+bool ConstantTime::equal(const void* a, const void* b, size_t len) {
+    // volatile не даёт компилятору заменить цикл досрочно завершающимся memcmp.
+    const volatile uint8_t* x = static_cast<const volatile uint8_t*>(a);
+    const volatile uint8_t* y = static_cast<const volatile uint8_t*>(b);
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; ++i)
+        diff |= static_cast<uint8_t>(x[i] ^ y[i]);
+
+    // 1, если diff == 0, иначе 0 — без условного перехода.
+    return ((static_cast<uint32_t>(diff) - 1) >> 8) & 1;
+}
+
+bool ConstantTime::equal(const SHA256::Digest& a, const SHA256::Digest& b) {
+    return equal(a.data(), b.data(), SHA256::DIGEST_SIZE);
+}
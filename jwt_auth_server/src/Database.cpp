@@ -1,86 +1,97 @@
 #include "../include/Database.h"
 #include "../include/PasswordEncryptor.h"
-#include <sqlite3.h>
+#include "../include/UserCache.h"
+#include "../include/SqliteStore.h"
+#include "../include/LogStore.h"
 #include <iostream>
 #include <ctime>
+#include <memory>
 
-sqlite3* db = nullptr;
+namespace {
+    std::unique_ptr<SqliteStore> sqlite_store;
+    std::unique_ptr<LogUserStore> log_user_store;
+    std::unique_ptr<LogRevocationStore> log_revocation_store;
+
+    UserStore* users = nullptr;
+    RevocationStore* revocations = nullptr;
+
+    /**
+     * @brief Проверяет, реализованы ли оба интерфейса одним объектом (тогда пакет — одна транзакция).
+     */
+    bool sameBackend() {
+        return dynamic_cast<void*>(users) == dynamic_cast<void*>(revocations);
+    }
+}
 
 bool Database::init(const std::string& db_path) {
-    int rc = sqlite3_open(db_path.c_str(), &db);
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << "\n";
-        return false;
+    StorageOptions options;
+    options.sqlitePath = db_path;
+    return init(options);
+}
+
+bool Database::init(const StorageOptions& options) {
+    bool needSqlite = options.userEngine == StorageEngine::SQLite ||
+                      options.revocationEngine == StorageEngine::SQLite;
+
+    if (needSqlite) {
+        sqlite_store = std::make_unique<SqliteStore>();
+        if (!sqlite_store->open(SqliteStore::shardPaths(options.sqlitePath, options.sqliteShards))) return false;
     }
 
-    const char* create_users_sql = R"(
-        CREATE TABLE IF NOT EXISTS users (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            username TEXT UNIQUE NOT NULL,
-            password TEXT NOT NULL
-        );
-    )";
-
-    const char* create_blacklist_sql = R"(
-        CREATE TABLE IF NOT EXISTS blacklist (
-            token TEXT PRIMARY KEY,
-            expires_at INTEGER NOT NULL
-        );
-    )";
-
-    char* errMsg = nullptr;
-
-    rc = sqlite3_exec(db, create_users_sql, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "SQL error (users): " << errMsg << "\n";
-        sqlite3_free(errMsg);
-        return false;
+    if (options.userEngine == StorageEngine::MappedLog) {
+        log_user_store = std::make_unique<LogUserStore>();
+        if (!log_user_store->open(options.userLogPath, options.logOptions)) return false;
+        users = log_user_store.get();
+    } else {
+        users = sqlite_store.get();
     }
 
-    rc = sqlite3_exec(db, create_blacklist_sql, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "SQL error (blacklist): " << errMsg << "\n";
-        sqlite3_free(errMsg);
-        return false;
+    if (options.revocationEngine == StorageEngine::MappedLog) {
+        log_revocation_store = std::make_unique<LogRevocationStore>();
+        if (!log_revocation_store->open(options.revocationLogPath, options.logOptions)) return false;
+        revocations = log_revocation_store.get();
+    } else {
+        revocations = sqlite_store.get();
     }
 
     std::cout << "Database initialized successfully.\n";
     return true;
 }
 
-bool Database::addUser(const std::string& username, const std::string& password) {
-    std::string hashed = PasswordEncryptor::hashPassword(password);
-    const char* sql = "INSERT INTO users (username, password) VALUES (?, ?);";
-
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+void Database::close() {
+    users = nullptr;
+    revocations = nullptr;
+    log_user_store.reset();
+    log_revocation_store.reset();
+    sqlite_store.reset();
+    std::cout << "Database closed.\n";
+}
 
-    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, hashed.c_str(), -1, SQLITE_TRANSIENT);
+bool Database::addUser(const std::string& username, const std::string& password) {
+    return insertUser(username, PasswordEncryptor::hashPassword(password));
+}
 
-    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
+bool Database::insertUser(const std::string& username, const std::string& hashed) {
+    bool success = users->insertUser(username, hashed);
+    UserCache::invalidate(username);
     return success;
 }
 
 bool Database::getUser(const std::string& username, User& user_out) {
-    const char* sql = "SELECT id, username, password FROM users WHERE username = ?;";
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
-
-    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_TRANSIENT);
-
-    bool found = false;
-    int rc = sqlite3_step(stmt);
-    if (rc == SQLITE_ROW) {
-        user_out.id = sqlite3_column_int(stmt, 0);
-        user_out.username = (const char*)sqlite3_column_text(stmt, 1);
-        user_out.password = (const char*)sqlite3_column_text(stmt, 2);
-        found = true;
+    uint64_t generation = 0;
+    switch (UserCache::lookup(username, user_out, generation)) {
+        case UserCache::Lookup::Hit: return true;
+        case UserCache::Lookup::KnownMissing: return false;
+        case UserCache::Lookup::Miss: break;
     }
 
-    sqlite3_finalize(stmt);
-    return found;
+    LookupResult result = users->findUser(username, user_out);
+    if (result == LookupResult::Found)
+        UserCache::put(user_out, generation);
+    else if (result == LookupResult::NotFound)
+        UserCache::putMissing(username, generation);
+
+    return result == LookupResult::Found;
 }
 
 // ===========================
@@ -88,38 +99,72 @@ bool Database::getUser(const std::string& username, User& user_out) {
 // ===========================
 
 bool Database::blacklistToken(const std::string& token, uint64_t expires_at) {
-    const char* sql = "INSERT OR IGNORE INTO blacklist (token, expires_at) VALUES (?, ?);";
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+    return revocations->blacklistToken(token, expires_at);
+}
 
-    sqlite3_bind_text(stmt, 1, token.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(expires_at));
+bool Database::isTokenBlacklisted(const std::string& token) {
+    return revocations->isTokenBlacklisted(token);
+}
 
-    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
-    return success;
+bool Database::findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked) {
+    return revocations->findBlacklisted(tokens, revoked);
 }
 
-bool Database::isTokenBlacklisted(const std::string& token) {
-    const char* sql = "SELECT 1 FROM blacklist WHERE token = ? LIMIT 1;";
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+bool Database::cleanupBlacklist() {
+    const int batchSize = 500;
+    uint64_t now = static_cast<uint64_t>(std::time(nullptr));
 
-    sqlite3_bind_text(stmt, 1, token.c_str(), -1, SQLITE_TRANSIENT);
+    int deleted;
+    do {
+        deleted = purgeExpiredBlacklist(batchSize, now);
+        if (deleted < 0) return false;
+    } while (deleted == batchSize);
 
-    bool found = (sqlite3_step(stmt) == SQLITE_ROW);
-    sqlite3_finalize(stmt);
-    return found;
+    return true;
 }
 
-bool Database::cleanupBlacklist() {
-    const char* sql = "DELETE FROM blacklist WHERE expires_at < ?;";
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+int Database::purgeExpiredBlacklist(int batchSize, uint64_t now) {
+    return revocations->purgeExpired(batchSize, now);
+}
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(std::time(nullptr)));
+// ===========================
+// BATCH WRITES
+// ===========================
 
-    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
-    return success;
+bool Database::applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) {
+    bool committed = true;
+
+    if (sameBackend()) {
+        committed = users->applyBatch(ops, results);
+    } else {
+        std::vector<WriteOp> userOps, revocationOps;
+        std::vector<size_t> userIdx, revocationIdx;
+        for (size_t i = 0; i < ops.size(); ++i) {
+            if (ops[i].type != WriteOp::Type::BlacklistToken) {
+                userOps.push_back(ops[i]);
+                userIdx.push_back(i);
+            } else {
+                revocationOps.push_back(ops[i]);
+                revocationIdx.push_back(i);
+            }
+        }
+
+        results.assign(ops.size(), false);
+        std::vector<bool> partial;
+        if (!userOps.empty()) {
+            committed &= users->applyBatch(userOps, partial);
+            for (size_t i = 0; i < userIdx.size(); ++i) results[userIdx[i]] = partial[i];
+        }
+        if (!revocationOps.empty()) {
+            committed &= revocations->applyBatch(revocationOps, partial);
+            for (size_t i = 0; i < revocationIdx.size(); ++i) results[revocationIdx[i]] = partial[i];
+        }
+    }
+
+    for (const WriteOp& op : ops) {
+        if (op.type != WriteOp::Type::BlacklistToken)
+            UserCache::invalidate(op.key);
+    }
+
+    return committed;
 }
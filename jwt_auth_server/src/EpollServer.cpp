@@ -0,0 +1,469 @@
+#include "../include/EpollServer.h"
+#include "../include/HttpProtocol.h"
+#include "../include/HashExecutor.h"
+#include "../include/extern/httplib.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const int MAX_EVENTS = 256;             ///< Событий за один epoll_wait.
+    const size_t READ_CHUNK = 16384;        ///< Размер буфера чтения на стеке.
+
+    /**
+     * @brief Клиентское соединение; принадлежит одному циклу.
+     */
+    struct Connection {
+        int fd = -1;
+        HttpSession session;
+        uint32_t events = 0;             ///< Текущая маска epoll.
+        Clock::time_point lastActive;
+    };
+
+    /**
+     * @brief Ответ, подготовленный в пуле и возвращаемый в цикл.
+     */
+    struct Completion {
+        int fd;
+        uint64_t id;
+        std::string response;
+        bool close;
+    };
+
+    std::atomic<bool> stop_requested{false};
+    std::atomic<bool> drain_requested{false};
+    std::atomic<int> drain_timeout_sec{0};
+
+    class EventLoop;
+    std::mutex loops_mutex;
+    std::vector<EventLoop*> active_loops;
+
+    /**
+     * @brief Цикл событий одного ядра: свой слушающий сокет, epoll и соединения.
+     */
+    class EventLoop {
+    public:
+        EventLoop(size_t index, const HttpSettings& settings, httplib::ThreadPool& pool)
+            : index(index), settings(settings), pool(pool) {}
+
+        ~EventLoop() {
+            for (auto& entry : connections) ::close(entry.first);
+            if (listenFd >= 0) ::close(listenFd);
+            if (wakeFd >= 0) ::close(wakeFd);
+            if (epollFd >= 0) ::close(epollFd);
+        }
+
+        /**
+         * @brief Открывает слушающий сокет (SO_REUSEPORT), epoll и eventfd.
+         */
+        bool open(const addrinfo* addr) {
+            listenFd = HttpProtocol::listenReusePort(addr, settings.listenBacklog, true);
+            if (listenFd < 0) return false;
+
+            epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (epollFd < 0) return fail("epoll_create1");
+            wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (wakeFd < 0) return fail("eventfd");
+
+            return watch(listenFd, EPOLLIN, EPOLL_CTL_ADD) && watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+        }
+
+        void run() {
+            int cpu = HttpProtocol::pinToCore(index);
+            if (cpu >= 0) std::cout << "[EpollServer] Цикл #" << index << " закреплён за CPU " << cpu << std::endl;
+
+            epoll_event events[MAX_EVENTS];
+            Clock::time_point lastSweep = Clock::now();
+
+            while (!stop_requested) {
+                if (drain_requested && !draining) beginDrain();
+
+                int n = ::epoll_wait(epollFd, events, MAX_EVENTS, draining ? 100 : 1000);
+                if (n < 0 && errno != EINTR) {
+                    std::cerr << "[EpollServer] Цикл #" << index << ": epoll_wait: " << std::strerror(errno) << std::endl;
+                    break;
+                }
+
+                for (int i = 0; i < n; ++i) {
+                    int fd = events[i].data.fd;
+                    uint32_t ev = events[i].events;
+
+                    if (fd == listenFd) {
+                        acceptAll();
+                    } else if (fd == wakeFd) {
+                        uint64_t count;
+                        while (::read(wakeFd, &count, sizeof(count)) > 0) {}
+                        processCompletions();
+                    } else {
+                        auto it = connections.find(fd);
+                        if (it == connections.end()) continue;
+                        Connection& conn = *it->second;
+
+                        if (ev & (EPOLLERR | EPOLLHUP)) {
+                            closeConnection(conn);
+                            continue;
+                        }
+                        if ((ev & EPOLLIN) && !onReadable(conn)) continue;
+                        if (ev & EPOLLOUT) flush(conn);
+                    }
+                }
+
+                Clock::time_point now = Clock::now();
+                if (draining) {
+                    closeDrained();
+                    if (connections.empty()) break;
+                    if (now >= drainDeadline) {
+                        std::cerr << "[EpollServer] Цикл #" << index << ": срок остановки истёк, обрываю соединений: "
+                                  << connections.size() << std::endl;
+                        break;
+                    }
+                }
+                if (now - lastSweep >= std::chrono::seconds(1)) {
+                    closeIdle(now);
+                    lastSweep = now;
+                }
+            }
+        }
+
+        /**
+         * @brief Передаёт ответ из пула в цикл (потокобезопасно).
+         */
+        void complete(Completion completion) {
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back(std::move(completion));
+            }
+            wake();
+        }
+
+        void wake() {
+            uint64_t one = 1;
+            ssize_t written = ::write(wakeFd, &one, sizeof(one));
+            (void)written;
+        }
+
+    private:
+        size_t index;
+        const HttpSettings& settings;
+        httplib::ThreadPool& pool;
+
+        int listenFd = -1;
+        int epollFd = -1;
+        int wakeFd = -1;
+        uint64_t nextId = 1;
+        std::unordered_map<int, std::unique_ptr<Connection>> connections;
+        bool draining = false;
+        Clock::time_point drainDeadline;
+
+        std::mutex completedMutex;
+        std::vector<Completion> completed;
+
+        bool fail(const char* what) {
+            std::cerr << "[EpollServer] Цикл #" << index << ": " << what << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        bool watch(int fd, uint32_t events, int op) {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.fd = fd;
+            if (::epoll_ctl(epollFd, op, fd, &ev) != 0) return fail("epoll_ctl");
+            return true;
+        }
+
+        void acceptAll() {
+            while (true) {
+                sockaddr_storage addr{};
+                socklen_t len = sizeof(addr);
+                int fd = ::accept4(listenFd, reinterpret_cast<sockaddr*>(&addr), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno == EINTR) continue;
+                    if (errno == EMFILE || errno == ENFILE)
+                        std::cerr << "[EpollServer] Исчерпан лимит файловых дескрипторов" << std::endl;
+                    return;
+                }
+
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                auto conn = std::make_unique<Connection>();
+                conn->fd = fd;
+                conn->session.id = nextId++;
+                conn->session.draining = draining;
+                conn->lastActive = Clock::now();
+
+                char host[INET6_ADDRSTRLEN] = {};
+                if (addr.ss_family == AF_INET) {
+                    auto* in = reinterpret_cast<sockaddr_in*>(&addr);
+                    ::inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+                    conn->session.remotePort = ntohs(in->sin_port);
+                } else if (addr.ss_family == AF_INET6) {
+                    auto* in6 = reinterpret_cast<sockaddr_in6*>(&addr);
+                    ::inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+                    conn->session.remotePort = ntohs(in6->sin6_port);
+                }
+                conn->session.remoteAddr = host;
+
+                conn->events = EPOLLIN;
+                if (!watch(fd, conn->events, EPOLL_CTL_ADD)) {
+                    ::close(fd);
+                    continue;
+                }
+                connections.emplace(fd, std::move(conn));
+            }
+        }
+
+        /**
+         * @brief Читает всё доступное и обрабатывает готовые запросы.
+         * @return false, если соединение закрыто.
+         */
+        bool onReadable(Connection& conn) {
+            char buf[READ_CHUNK];
+            while (true) {
+                ssize_t n = ::read(conn.fd, buf, sizeof(buf));
+                if (n > 0) {
+                    conn.session.in.append(buf, static_cast<size_t>(n));
+                    continue;
+                }
+                if (n == 0) {
+                    conn.session.peerClosed = true;
+                    break;
+                }
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                closeConnection(conn);
+                return false;
+            }
+
+            conn.lastActive = Clock::now();
+            return processInput(conn);
+        }
+
+        /**
+         * @brief Выполняет готовые запросы и отправляет ответы.
+         * @return false, если соединение закрыто.
+         */
+        bool processInput(Connection& conn) {
+            int fd = conn.fd;
+            uint64_t id = conn.session.id;
+            HttpProtocol::process(conn.session, settings,
+                [this, fd, id](const Route* route, std::shared_ptr<httplib::Request> request, const AuthContext& auth,
+                             bool keepAlive) {
+                    return pool.enqueue([this, route, request, auth, fd, id, keepAlive] {
+                        std::string response;
+                        HttpProtocol::respond(*route, *request, auth, keepAlive, response);
+                        complete(Completion{fd, id, std::move(response), !keepAlive});
+                    });
+                });
+            return flush(conn);
+        }
+
+        void processCompletions() {
+            std::vector<Completion> ready;
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                ready.swap(completed);
+            }
+
+            for (Completion& completion : ready) {
+                auto it = connections.find(completion.fd);
+                if (it == connections.end() || it->second->session.id != completion.id) continue; // клиент уже ушёл
+
+                Connection& conn = *it->second;
+                HttpProtocol::complete(conn.session, std::move(completion.response), completion.close);
+                conn.lastActive = Clock::now();
+                processInput(conn);
+            }
+        }
+
+        /**
+         * @brief Отправляет накопленные ответы и обновляет маску epoll.
+         * @return false, если соединение закрыто.
+         */
+        bool flush(Connection& conn) {
+            HttpSession& session = conn.session;
+            while (session.hasOutput()) {
+                ssize_t n = ::send(conn.fd, session.out.data() + session.outOffset, session.out.size() - session.outOffset,
+                                   MSG_NOSIGNAL);
+                if (n > 0) {
+                    session.consumeOutput(static_cast<size_t>(n));
+                    conn.lastActive = Clock::now();
+                    continue;
+                }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                closeConnection(conn);
+                return false;
+            }
+
+            if (session.finished()) {
+                closeConnection(conn);
+                return false;
+            }
+
+            uint32_t events = 0;
+            if (session.wantsRead()) events |= EPOLLIN;
+            if (session.hasOutput()) events |= EPOLLOUT;
+            if (events != conn.events) {
+                conn.events = events;
+                watch(conn.fd, events, EPOLL_CTL_MOD);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Начало плавной остановки: принимает очередь слушающего сокета и закрывает его.
+         */
+        void beginDrain() {
+            draining = true;
+            drainDeadline = Clock::now() + std::chrono::seconds(drain_timeout_sec.load());
+            acceptAll();
+            ::epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+            ::close(listenFd);
+            listenFd = -1;
+
+            for (auto& entry : connections) entry.second->session.draining = true;
+            std::cout << "[EpollServer] Цикл #" << index << ": приём остановлен, соединений: " << connections.size()
+                      << std::endl;
+        }
+
+        /**
+         * @brief Закрывает соединения, которым больше нечего отправлять.
+         *
+         * Перед закрытием дочитывает сокет: запрос, уже пришедший по keep-alive соединению,
+         * выполняется (с `Connection: close`), а не теряется. Соединение, ещё не приславшее
+         * ни одного запроса, ждёт его до срока остановки.
+         */
+        void closeDrained() {
+            std::vector<int> idle;
+            for (auto& entry : connections) {
+                const HttpSession& session = entry.second->session;
+                if (session.served && !session.pending && !session.hasOutput() && session.in.empty())
+                    idle.push_back(entry.first);
+            }
+            for (int fd : idle) {
+                auto it = connections.find(fd);
+                if (it == connections.end() || !onReadable(*it->second)) continue;
+                const HttpSession& session = it->second->session;
+                if (!session.pending && !session.hasOutput() && session.in.empty()) closeConnection(*it->second);
+            }
+        }
+
+        void closeConnection(Connection& conn) {
+            int fd = conn.fd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            connections.erase(fd);
+        }
+
+        /**
+         * @brief Закрывает соединения, простаивающие дольше таймаута.
+         *
+         * Незаконченный запрос ограничен read-timeout, неотправленный ответ — write-timeout,
+         * пустое keep-alive соединение — keep-alive-timeout.
+         */
+        void closeIdle(Clock::time_point now) {
+            std::vector<int> expired;
+            for (auto& entry : connections) {
+                const Connection& conn = *entry.second;
+                if (conn.session.pending) continue;
+
+                int limit = conn.session.hasOutput() ? settings.writeTimeoutSec
+                          : !conn.session.in.empty() ? settings.readTimeoutSec
+                                              : settings.keepAliveTimeoutSec;
+                if (now - conn.lastActive > std::chrono::seconds(limit)) expired.push_back(entry.first);
+            }
+            for (int fd : expired) closeConnection(*connections[fd]);
+        }
+    };
+}
+
+bool EpollServer::run(const HttpSettings& settings) {
+    stop_requested = false;   // drain_requested не сбрасывается: drain() мог прийти до запуска
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addr = nullptr;
+    std::string port = std::to_string(settings.port);
+    if (::getaddrinfo(settings.host.c_str(), port.c_str(), &hints, &addr) != 0 || !addr) {
+        std::cerr << "[EpollServer] Не удалось разрешить адрес " << settings.host << std::endl;
+        return false;
+    }
+
+    size_t loopCount = settings.eventLoops ? settings.eventLoops
+                                           : std::max(1u, std::thread::hardware_concurrency());
+    size_t baseWorkers = settings.workers ? settings.workers : CPPHTTPLIB_THREAD_POOL_COUNT;
+    size_t poolSize = baseWorkers + HashExecutor::capacity();
+    httplib::ThreadPool pool(poolSize, settings.maxQueuedRequests);
+
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    for (size_t i = 0; i < loopCount; ++i) {
+        loops.push_back(std::make_unique<EventLoop>(i, settings, pool));
+        if (!loops.back()->open(addr)) {
+            std::cerr << "[EpollServer] Не удалось занять " << settings.host << ":" << settings.port << std::endl;
+            ::freeaddrinfo(addr);
+            pool.shutdown();
+            return false;
+        }
+    }
+    ::freeaddrinfo(addr);
+
+    {
+        std::lock_guard<std::mutex> lock(loops_mutex);
+        for (auto& loop : loops) active_loops.push_back(loop.get());
+    }
+
+    std::cout << "[EpollServer] Сервер запущен на " << settings.host << ":" << settings.port << ", циклов событий "
+              << loopCount << ", пул для блокирующих маршрутов " << poolSize
+              << ", очередь до " << settings.maxQueuedRequests << std::endl;
+
+    std::vector<std::thread> threads;
+    for (auto& loop : loops)
+        threads.emplace_back(&EventLoop::run, loop.get());
+    for (auto& t : threads) t.join();
+
+    {
+        std::lock_guard<std::mutex> lock(loops_mutex);
+        active_loops.clear();
+    }
+
+    // Задачи пула ссылаются на циклы — дожидаемся их до разрушения циклов.
+    pool.shutdown();
+    std::cout << "[EpollServer] Остановлен" << std::endl;
+    return true;
+}
+
+void EpollServer::stop() {
+    stop_requested = true;
+    std::lock_guard<std::mutex> lock(loops_mutex);
+    for (EventLoop* loop : active_loops) loop->wake();
+}
+
+void EpollServer::drain(std::chrono::seconds timeout) {
+    drain_timeout_sec = static_cast<int>(timeout.count());
+    drain_requested = true;
+    std::lock_guard<std::mutex> lock(loops_mutex);
+    for (EventLoop* loop : active_loops) loop->wake();
+}
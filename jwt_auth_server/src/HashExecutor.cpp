@@ -0,0 +1,158 @@
+#include "../include/HashExecutor.h"
+#include "../include/PasswordEncryptor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Задача в очереди вместе с моментом постановки.
+     */
+    struct HashTask {
+        std::function<void()> run;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<HashTask> pending;
+    bool running = false;
+    bool stop_requested = false;
+    size_t max_queue = 0;
+
+    std::atomic<uint64_t> stat_submitted{0};
+    std::atomic<uint64_t> stat_rejected{0};
+    std::atomic<uint64_t> stat_completed{0};
+    std::atomic<uint64_t> stat_wait_us{0};
+    std::atomic<uint64_t> stat_work_us{0};
+    std::atomic<uint64_t> stat_max_depth{0};
+
+    uint64_t microsSince(std::chrono::steady_clock::time_point from) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - from).count());
+    }
+
+    void workerLoop() {
+        while (true) {
+            HashTask task;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [] { return stop_requested || !pending.empty(); });
+                if (pending.empty()) return; // stop_requested и очередь пуста
+                task = std::move(pending.front());
+                pending.pop_front();
+            }
+
+            stat_wait_us += microsSince(task.enqueuedAt);
+            auto start = std::chrono::steady_clock::now();
+            task.run();
+            stat_work_us += microsSince(start);
+            stat_completed++;
+        }
+    }
+
+    /**
+     * @brief Ставит задачу в очередь, если в ней есть место.
+     *
+     * @return Future результата или std::nullopt при переполнении.
+     */
+    template <typename T>
+    std::optional<std::future<T>> submit(std::function<T()> fn) {
+        auto task = std::make_shared<std::packaged_task<T()>>(std::move(fn));
+        std::future<T> result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (running) {
+                if (pending.size() >= max_queue) {
+                    stat_rejected++;
+                    return std::nullopt;
+                }
+                pending.push_back(HashTask{[task] { (*task)(); }, std::chrono::steady_clock::now()});
+                stat_submitted++;
+                uint64_t depth = pending.size();
+                uint64_t prev = stat_max_depth.load();
+                while (depth > prev && !stat_max_depth.compare_exchange_weak(prev, depth)) {}
+                queue_cv.notify_one();
+                return result;
+            }
+        }
+
+        // Пул не запущен — выполняем синхронно.
+        stat_submitted++;
+        auto start = std::chrono::steady_clock::now();
+        (*task)();
+        stat_work_us += microsSince(start);
+        stat_completed++;
+        return result;
+    }
+}
+
+void HashExecutor::start(size_t threads, size_t maxQueue) {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    if (running) return;
+
+    max_queue = maxQueue;
+    running = true;
+    stop_requested = false;
+    if (threads == 0) threads = 1;
+
+    std::cout << "[HashExecutor] Запуск: " << threads << " потоков, очередь до "
+              << max_queue << " задач" << std::endl;
+
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back(workerLoop);
+}
+
+void HashExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!running) return;
+        stop_requested = true;
+    }
+    queue_cv.notify_all();
+    for (auto& t : workers)
+        if (t.joinable()) t.join();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        workers.clear();
+        running = false;
+    }
+    std::cout << "[HashExecutor] Остановлен" << std::endl;
+}
+
+size_t HashExecutor::capacity() {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return running ? workers.size() + max_queue : 0;
+}
+
+std::optional<std::future<std::string>> HashExecutor::hashPassword(const std::string& password) {
+    return submit<std::string>([password] { return PasswordEncryptor::hashPassword(password); });
+}
+
+std::optional<std::future<bool>> HashExecutor::verifyPassword(const std::string& password, const std::string& encoded) {
+    return submit<bool>([password, encoded] { return PasswordEncryptor::verifyPassword(password, encoded); });
+}
+
+bool HashExecutor::post(std::function<void()> task) {
+    return submit<void>(std::move(task)).has_value();
+}
+
+HashExecutorStats HashExecutor::getStats() {
+    HashExecutorStats stats;
+    stats.submitted = stat_submitted.load();
+    stats.rejected = stat_rejected.load();
+    stats.completed = stat_completed.load();
+    stats.queueWaitMicros = stat_wait_us.load();
+    stats.workMicros = stat_work_us.load();
+    stats.maxQueueDepth = stat_max_depth.load();
+    return stats;
+}
@@ -0,0 +1,304 @@
+#include "../include/HttpProtocol.h"
+#include "../include/StaticResponse.h"
+
+#include <netdb.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const size_t MAX_HEADER_BYTES = 8192;   ///< Предел строки запроса и заголовков.
+
+    enum class ParseResult { Complete, Incomplete, Error };
+
+    std::string toLower(std::string_view s) {
+        std::string out(s);
+        for (char& c : out) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return out;
+    }
+
+    std::string_view trimView(std::string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        return s;
+    }
+
+    /**
+     * @brief Разбирает один запрос из начала буфера.
+     *
+     * @param[out] consumed Байт, занятых запросом.
+     * @param[out] errorStatus Код ответа, если результат Error.
+     * @param[out] keepAlive Хочет ли клиент сохранить соединение.
+     */
+    ParseResult parseRequest(const std::string& buf, size_t payloadMax, httplib::Request& req,
+                             size_t& consumed, int& errorStatus, bool& keepAlive) {
+        size_t headerEnd = buf.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) {
+            if (buf.size() > MAX_HEADER_BYTES) {
+                errorStatus = 431;
+                return ParseResult::Error;
+            }
+            return ParseResult::Incomplete;
+        }
+        if (headerEnd > MAX_HEADER_BYTES) {
+            errorStatus = 431;
+            return ParseResult::Error;
+        }
+
+        std::string_view head(buf.data(), headerEnd);
+        size_t lineEnd = std::min(head.find("\r\n"), head.size());
+        std::string_view requestLine = head.substr(0, lineEnd);
+
+        size_t sp1 = requestLine.find(' ');
+        size_t sp2 = (sp1 == std::string_view::npos) ? sp1 : requestLine.find(' ', sp1 + 1);
+        if (sp1 == std::string_view::npos || sp2 == std::string_view::npos || sp1 == 0 || sp2 == sp1 + 1) {
+            errorStatus = 400;
+            return ParseResult::Error;
+        }
+        req.method = std::string(requestLine.substr(0, sp1));
+        req.target = std::string(requestLine.substr(sp1 + 1, sp2 - sp1 - 1));
+        req.version = std::string(requestLine.substr(sp2 + 1));
+        if (req.version != "HTTP/1.1" && req.version != "HTTP/1.0") {
+            errorStatus = 505;
+            return ParseResult::Error;
+        }
+
+        size_t pos = lineEnd + 2;
+        while (pos < head.size()) {
+            size_t next = std::min(head.find("\r\n", pos), head.size());
+            std::string_view line = head.substr(pos, next - pos);
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos || colon == 0) {
+                errorStatus = 400;
+                return ParseResult::Error;
+            }
+            req.headers.emplace(std::string(line.substr(0, colon)), std::string(trimView(line.substr(colon + 1))));
+            pos = next + 2;
+        }
+
+        if (req.has_header("Transfer-Encoding")) {
+            errorStatus = 411;
+            return ParseResult::Error;
+        }
+
+        size_t contentLength = 0;
+        if (req.has_header("Content-Length")) {
+            const std::string& value = req.get_header_value("Content-Length");
+            auto result = std::from_chars(value.data(), value.data() + value.size(), contentLength);
+            if (result.ec != std::errc() || result.ptr != value.data() + value.size()) {
+                errorStatus = 400;
+                return ParseResult::Error;
+            }
+        }
+        if (contentLength > payloadMax) {
+            errorStatus = 413;
+            return ParseResult::Error;
+        }
+
+        size_t bodyStart = headerEnd + 4;
+        if (buf.size() < bodyStart + contentLength) return ParseResult::Incomplete;
+        req.body.assign(buf, bodyStart, contentLength);
+        req.start_time_ = std::chrono::steady_clock::now();
+        consumed = bodyStart + contentLength;
+
+        size_t query = req.target.find('?');
+        req.path = httplib::detail::decode_url(req.target.substr(0, query), false);
+        if (query != std::string::npos)
+            httplib::detail::parse_query_text(req.target.substr(query + 1), req.params);
+
+        std::string connection = toLower(req.get_header_value("Connection"));
+        keepAlive = (req.version == "HTTP/1.0") ? connection == "keep-alive" : connection != "close";
+        return ParseResult::Complete;
+    }
+
+    /**
+     * @brief Строки StaticResponses::commonHeaders(), собранные один раз.
+     */
+    const std::string& commonHeaderBlock() {
+        static const std::string block = [] {
+            std::string out;
+            for (const auto& header : StaticResponses::commonHeaders()) {
+                out += header.first;
+                out += ": ";
+                out += header.second;
+                out += "\r\n";
+            }
+            return out;
+        }();
+        return block;
+    }
+
+    /**
+     * @brief Выполняет обработчик маршрута (или отвечает 404) и пишет строку в лог.
+     *
+     * @param auth Токен запроса, уже допущенного HttpServer::admit(); nullptr — допустить здесь.
+     * @return Фиксированный ответ или nullptr, если обработчик заполнил res.
+     */
+    const StaticResponse* execute(const Route* route, const httplib::Request& req, const AuthContext* auth,
+                                  httplib::Response& res) {
+        const StaticResponse* fixed = nullptr;
+        if (!route) {
+            fixed = &StaticResponses::get(StaticResponseId::NotFound);
+        } else {
+            try {
+                fixed = auth ? HttpServer::dispatch(*route, req, *auth, res) : HttpServer::dispatch(*route, req, res);
+                if (res.status == -1) res.status = 200;
+            } catch (const std::exception& e) {
+                std::cerr << "[HttpServer] Исключение в обработчике " << req.path << ": " << e.what() << std::endl;
+                fixed = &StaticResponses::get(StaticResponseId::InternalError);
+            }
+        }
+        HttpServer::logRequest(req, fixed ? fixed->status : res.status);
+        return fixed;
+    }
+}
+
+void HttpProtocol::process(HttpSession& session, const HttpSettings& settings, const HttpOffload& offload) {
+    while (!session.pending && !session.closeAfterWrite && !session.in.empty()) {
+        httplib::Request req;
+        size_t consumed = 0;
+        int errorStatus = 0;
+        bool keepAlive = false;
+
+        ParseResult result = parseRequest(session.in, settings.payloadMaxBytes, req, consumed, errorStatus, keepAlive);
+        if (result == ParseResult::Incomplete) break;
+        if (result == ParseResult::Error) {
+            session.out += StaticResponses::forStatus(errorStatus).wire(false);
+            session.closeAfterWrite = true;
+            session.in.clear();
+            break;
+        }
+
+        session.in.erase(0, consumed);
+        session.served++;
+        if (session.served >= settings.keepAliveMaxCount || session.draining) keepAlive = false;
+        req.remote_addr = session.remoteAddr;
+        req.remote_port = session.remotePort;
+
+        const Route* route = HttpServer::findRoute(req.method, req.path);
+        if (route && route->blocking) {
+            auto request = std::make_shared<httplib::Request>(std::move(req));
+            AuthContext auth;
+            if (const StaticResponse* denied = HttpServer::admit(*route, *request, auth)) {
+                HttpServer::logRequest(*request, denied->status);
+                session.out += denied->wire(keepAlive);
+            } else {
+                session.pending = true;
+                if (!offload(route, request, auth, keepAlive)) {
+                    session.pending = false;
+                    const StaticResponse& busy = StaticResponses::get(StaticResponseId::ServerBusy);
+                    HttpServer::logRequest(*request, busy.status);
+                    session.out += busy.wire(keepAlive);
+                }
+            }
+        } else {
+            respond(route, req, keepAlive, session.out);
+        }
+        if (!keepAlive) {
+            session.closeAfterWrite = true;
+            session.in.clear();
+        }
+    }
+}
+
+void HttpProtocol::complete(HttpSession& session, std::string response, bool close) {
+    session.pending = false;
+    session.out += response;
+    if (close) session.closeAfterWrite = true;
+}
+
+namespace {
+    void respondWith(const Route* route, const httplib::Request& req, const AuthContext* auth, bool keepAlive,
+                     std::string& out) {
+        httplib::Response res;
+        if (const StaticResponse* fixed = execute(route, req, auth, res)) {
+            out += fixed->wire(keepAlive);
+            return;
+        }
+        HttpProtocol::serialize(res, keepAlive, out);
+    }
+}
+
+void HttpProtocol::respond(const Route* route, const httplib::Request& req, bool keepAlive, std::string& out) {
+    respondWith(route, req, nullptr, keepAlive, out);
+}
+
+void HttpProtocol::respond(const Route& route, const httplib::Request& req, const AuthContext& auth, bool keepAlive,
+                           std::string& out) {
+    respondWith(&route, req, &auth, keepAlive, out);
+}
+
+void HttpProtocol::serialize(const httplib::Response& res, bool keepAlive, std::string& out) {
+    out.reserve(out.size() + 192 + res.body.size());
+    out += "HTTP/1.1 ";
+    out += std::to_string(res.status);
+    out += ' ';
+    out += httplib::status_message(res.status);
+    out += "\r\n";
+    out += commonHeaderBlock();
+    for (const auto& header : res.headers) {
+        if (header.first == "Content-Length" || header.first == "Connection") continue;
+        out += header.first;
+        out += ": ";
+        out += header.second;
+        out += "\r\n";
+    }
+    // У 204 и 304 тела нет, а Content-Length 304 описывал бы несостоявшийся ответ 200.
+    if (res.status != 204 && res.status != 304) {
+        out += "Content-Length: ";
+        out += std::to_string(res.body.size());
+        out += "\r\n";
+    }
+    out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    out += res.body;
+}
+
+int HttpProtocol::listenReusePort(const addrinfo* addr, int backlog, bool nonBlocking) {
+    int type = SOCK_STREAM | SOCK_CLOEXEC | (nonBlocking ? SOCK_NONBLOCK : 0);
+    int fd = ::socket(addr->ai_family, type, addr->ai_protocol);
+    if (fd < 0) {
+        std::cerr << "[HttpServer] socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    const char* failed = nullptr;
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) failed = "SO_REUSEPORT";
+    else if (::bind(fd, addr->ai_addr, addr->ai_addrlen) != 0) failed = "bind";
+    else if (::listen(fd, backlog) != 0) failed = "listen";
+
+    if (failed) {
+        std::cerr << "[HttpServer] " << failed << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int HttpProtocol::pinToCore(size_t index) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return -1;
+
+    int count = CPU_COUNT(&allowed);
+    if (count <= 0) return -1;
+    int target = static_cast<int>(index % static_cast<size_t>(count));
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || target-- > 0) continue;
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        return ::pthread_setaffinity_np(::pthread_self(), sizeof(one), &one) == 0 ? cpu : -1;
+    }
+    return -1;
+}
@@ -1,337 +1,600 @@
 #include "../include/HttpServer.h"
+#include "../include/EpollServer.h"
+#include "../include/UringServer.h"
 #include "../include/extern/httplib.h"
 #include "../include/Database.h"
+#include "../include/WriteQueue.h"
+#include "../include/HashExecutor.h"
 #include "../include/PasswordEncryptor.h"
 #include "../include/JWT.h"
-#include "../include/KeyStorage.h"
-#include "../include/Base64URL.h"
+#include "../include/Jwks.h"
+#include "../include/Json.h"
+#include "../include/Metrics.h"
+#include "../include/BlacklistCleaner.h"
+#include "../include/TokenCache.h"
+#include "../include/UserCache.h"
 
+#include <chrono>
 #include <iostream>
+#include <mutex>
 #include <string>
 
-static std::string extractField(const std::string& json, const std::string& key) {
-    std::string pattern = "\"" + key + "\"";
-    size_t key_pos = json.find(pattern);
-    if (key_pos == std::string::npos) return "";
+/**
+ * @brief Учётные данные из тела /register и /login.
+ */
+struct Credentials {
+    JsonString<256> username;
+    JsonString<1024> password;
+};
 
-    size_t colon_pos = json.find(':', key_pos);
-    if (colon_pos == std::string::npos) return "";
+/**
+ * @brief Заполняет Credentials из событий Json::parseObject().
+ */
+class CredentialsHandler : public JsonHandler {
+public:
+    explicit CredentialsHandler(Credentials& creds) : creds(creds) {}
 
-    size_t quote_start = json.find('"', colon_pos + 1);
-    if (quote_start == std::string::npos) return "";
+    bool onField(const JsonField& field) override {
+        if (field.key == "username") return creds.username.assign(field);
+        if (field.key == "password") return creds.password.assign(field);
+        return true;
+    }
 
-    size_t quote_end = json.find('"', quote_start + 1);
-    if (quote_end == std::string::npos) return "";
+private:
+    Credentials& creds;
+};
 
-    return json.substr(quote_start + 1, quote_end - quote_start - 1);
+/**
+ * @brief Разбирает тело запроса за один проход.
+ * @return false, если JSON некорректен или username/password отсутствуют либо пусты.
+ */
+static bool parseCredentials(const std::string& body, Credentials& creds) {
+    CredentialsHandler handler(creds);
+    return Json::parseObject(body, handler) && creds.username.size > 0 && creds.password.size > 0;
 }
 
-void HttpServer::start(int port) {
-    httplib::Server server;
+static const size_t MAX_INTROSPECT_TOKENS = 100;   ///< Предел токенов в одном запросе /introspect.
 
-    server.set_logger([](const httplib::Request& req, const httplib::Response& res) {
-        std::cout << "[LOGGER] " << req.method << " " << req.path << " -> " << res.status << "\n";
-    });
+/**
+ * @brief Собирает строки массива `tokens` из тела /introspect.
+ */
+class TokenListHandler : public JsonHandler {
+public:
+    explicit TokenListHandler(std::vector<std::string>& tokens) : tokens(tokens) {}
 
-    server.Options(R"(.*)", [](const httplib::Request&, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "POST, GET, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
-        res.status = 200;
-    });    
-    
-    server.Post("/register", [](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        std::cout << "[REGISTER] Получен запрос: " << req.body << std::endl;
-
-        std::string username = extractField(req.body, "username");
-        std::string password = extractField(req.body, "password");
-
-        if (username.empty() || password.empty()) {
-            std::cerr << "[REGISTER] Отсутствует username или password" << std::endl;
-            res.status = 400;
-            res.set_content("Missing 'username' or 'password'", "text/plain");
-            return;
+    bool onField(const JsonField& element) override {
+        if (element.type != JsonType::String) return false;
+        if (tokens.size() >= MAX_INTROSPECT_TOKENS) {
+            tooMany = true;
+            return false;
         }
+        JsonString<4096> token;
+        if (!token.assign(element)) return false;
+        tokens.emplace_back(token.view());
+        return true;
+    }
 
-        std::cout << "[REGISTER] Имя пользователя: " << username << std::endl;
+    bool tooMany = false;   ///< Токенов больше MAX_INTROSPECT_TOKENS.
 
-        if (!Database::addUser(username, password)) {
-            std::cerr << "[REGISTER] Пользователь уже существует" << std::endl;
-            res.status = 409;
-            res.set_content("Username already exists", "text/plain");
-            return;
-        }
+private:
+    std::vector<std::string>& tokens;
+};
 
-        std::cout << "[REGISTER] Регистрация успешна" << std::endl;
-        res.status = 201;
-        res.set_content("User registered successfully", "text/plain");
-    });
+/**
+ * @brief Тело POST /introspect: `{"tokens": ["<jwt>", ...]}`.
+ */
+class IntrospectHandler : public JsonHandler {
+public:
+    explicit IntrospectHandler(std::vector<std::string>& tokens) : list(tokens) {}
 
-    server.Post("/login", [](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        std::cout << "[LOGIN] Получен запрос: " << req.body << std::endl;
+    bool onField(const JsonField& field) override {
+        if (field.key != "tokens") return true;
+        if (field.type != JsonType::Array || found) return false;
+        found = true;
+        return Json::parseArray(field.raw, list);
+    }
 
-        std::string username = extractField(req.body, "username");
-        std::string password = extractField(req.body, "password");
+    bool found = false;     ///< Поле tokens встретилось.
+    TokenListHandler list;
+};
 
-        if (username.empty() || password.empty()) {
-            std::cerr << "[LOGIN] Отсутствует username или password" << std::endl;
-            res.status = 400;
-            res.set_content("Missing 'username' or 'password'", "text/plain");
-            return;
-        }
+/**
+ * @brief Фиксированный ответ из StaticResponses.
+ */
+static const StaticResponse* reply(StaticResponseId id) {
+    return &StaticResponses::get(id);
+}
 
-        std::cout << "[LOGIN] Имя пользователя: " << username << std::endl;
+/**
+ * @brief OPTIONS * — ответ на CORS preflight.
+ */
+static const StaticResponse* handleOptions(const httplib::Request&, const AuthContext&, httplib::Response&) {
+    return reply(StaticResponseId::Preflight);
+}
 
-        User user;
-        if (!Database::getUser(username, user)) {
-            std::cerr << "[LOGIN] Пользователь не найден в базе данных" << std::endl;
-            res.status = 401;
-            res.set_content("Invalid credentials", "text/plain");
-            return;
-        }
+/**
+ * @brief POST /register — регистрация пользователя.
+ */
+static const StaticResponse* handleRegister(const httplib::Request& req, const AuthContext&, httplib::Response&) {
+    std::cout << "[REGISTER] Получен запрос: " << req.body << std::endl;
 
-        std::string hashedInput = PasswordEncryptor::hashPassword(password);
-        std::cout << "[LOGIN] Введённый пароль (хеш): " << hashedInput << std::endl;
-        std::cout << "[LOGIN] Хеш пароля из базы:      " << user.password << std::endl;
+    Credentials creds;
+    if (!parseCredentials(req.body, creds)) {
+        std::cerr << "[REGISTER] Отсутствует username или password" << std::endl;
+        return reply(StaticResponseId::MissingCredentials);
+    }
 
-        if (hashedInput != user.password) {
-            std::cerr << "[LOGIN] Неверный пароль" << std::endl;
-            res.status = 401;
-            res.set_content("Invalid credentials", "text/plain");
-            return;
-        }
+    std::string username(creds.username.view());
+    std::string password(creds.password.view());
 
-        RSAPublicKey pubKey;
-        RSAPrivateKey privKey;
-        if (!KeyStorage::loadKeys(pubKey, privKey)) {
-            std::cerr << "[LOGIN] Ошибка загрузки ключей" << std::endl;
-            res.status = 500;
-            res.set_content("Key error", "text/plain");
-            return;
-        }
+    std::cout << "[REGISTER] Имя пользователя: " << username << std::endl;
 
-        std::string accessToken = JWT::createAccessToken(username, 60 * 1, privKey);      // 1 минута
-        std::string refreshToken = JWT::createRefreshToken(username, 60 * 60, privKey);   // 60 минут
+    auto hashing = HashExecutor::hashPassword(password);
+    if (!hashing) {
+        std::cerr << "[REGISTER] Очередь хеширования переполнена" << std::endl;
+        return reply(StaticResponseId::ServerBusy);
+    }
 
-        std::cout << "[LOGIN] Сгенерирован Access токен:" << std::endl << accessToken << std::endl;
-        std::cout << "[LOGIN] Сгенерирован Refresh токен:" << std::endl << refreshToken << std::endl;
+    std::string hashed = hashing->get();
+    if (!WriteQueue::addUser(username, hashed).get()) {
+        std::cerr << "[REGISTER] Пользователь уже существует" << std::endl;
+        return reply(StaticResponseId::UserExists);
+    }
 
-        std::string response = "{";
-        response += "\"access_token\":\"" + accessToken + "\",";
-        response += "\"refresh_token\":\"" + refreshToken + "\"";
-        response += "}";
+    std::cout << "[REGISTER] Регистрация успешна" << std::endl;
+    return reply(StaticResponseId::UserRegistered);
+}
 
-        res.set_content(response, "application/json");
-        std::cout << "[LOGIN] Ответ отправлен клиенту\n" << std::endl;
-    });
+/**
+ * @brief POST /login — проверка пароля и выдача пары токенов.
+ */
+static const StaticResponse* handleLogin(const httplib::Request& req, const AuthContext&, httplib::Response& res) {
+    std::cout << "[LOGIN] Получен запрос: " << req.body << std::endl;
 
-    server.Post("/refresh", [](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        std::cout << "\n[SERVER] --- /refresh endpoint called ---\n";
-    
-        if (!req.has_header("Authorization")) {
-            std::cerr << "[ERROR] Missing Authorization header\n";
-            res.status = 400;
-            res.set_content("Missing Authorization header", "text/plain");
-            return;
-        }
-    
-        std::string authHeader = req.get_header_value("Authorization");
-        std::cout << "[HEADER] Authorization: " << authHeader << "\n";
-    
-        std::string prefix = "Bearer ";
-        if (authHeader.rfind(prefix, 0) != 0) {
-            std::cerr << "[ERROR] Authorization header must start with 'Bearer '\n";
-            res.status = 400;
-            res.set_content("Invalid Authorization header format", "text/plain");
-            return;
-        }
-    
-        std::string refreshToken = authHeader.substr(prefix.size());
-        std::cout << "[PARSE] Extracted refresh token: " << refreshToken << "\n";
-    
-        RSAPublicKey pubKey;
-        RSAPrivateKey privKey;
-        if (!KeyStorage::loadKeys(pubKey, privKey)) {
-            std::cerr << "[ERROR] Failed to load RSA keys from storage\n";
-            res.status = 500;
-            res.set_content("Key error", "text/plain");
-            return;
-        }
-    
-        std::string username;
-        std::cout << "[VERIFY] Verifying refresh token...\n";
-        if (!JWT::verifyRefreshToken(refreshToken, pubKey, username)) {
-            std::cerr << "[ERROR] Invalid or expired refresh token\n";
-            res.status = 401;
-            res.set_content("Invalid or expired refresh token", "text/plain");
-            return;
-        }
-    
-        std::cout << "[JWT] Refresh token is valid.\n";
-        std::cout << "[JWT] Extracted subject (username): " << username << "\n";
-    
-        if (Database::isTokenBlacklisted(refreshToken)) {
-            std::cerr << "[SECURITY] Refresh token is blacklisted. Rejected.\n";
-            res.status = 403;
-            res.set_content("Refresh token is blacklisted", "text/plain");
-            return;
-        }
-    
-        std::cout << "[JWT] Token is not in blacklist. Proceeding to generate new access token...\n";
-    
-        std::string newAccessToken = JWT::createAccessToken(username, 60, privKey);  // 1 минута
-        std::cout << "[JWT] New access token generated:\n" << newAccessToken << "\n";
-    
-        std::string response = "{";
-        response += "\"access_token\":\"" + newAccessToken + "\"";
-        response += "}";
-    
-        std::cout << "[RESPONSE] JSON: " << response << "\n";
-        std::cout << "[SERVER] --- /refresh complete ---\n";
-    
-        res.set_content(response, "application/json");
-    });    
-    
-    server.Get("/secure/data", [](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        std::cout << "\n[SERVER] --- /secure/data endpoint called ---\n";
-    
-        // [1] Проверяем заголовок Authorization
-        auto authHeaderIt = req.headers.find("Authorization");
-        if (authHeaderIt == req.headers.end()) {
-            std::cerr << "[ERROR] Missing 'Authorization' header\n";
-            res.status = 401;
-            res.set_content("Missing 'Authorization' header", "text/plain");
-            return;
-        }
-    
-        std::string authHeader = authHeaderIt->second;
-        std::cout << "[HEADER] Authorization: " << authHeader << "\n";
-    
-        if (authHeader.find("Bearer ") != 0) {
-            std::cerr << "[ERROR] Invalid Authorization format (should start with 'Bearer ')\n";
-            res.status = 400;
-            res.set_content("Invalid Authorization format", "text/plain");
-            return;
+    Credentials creds;
+    if (!parseCredentials(req.body, creds)) {
+        std::cerr << "[LOGIN] Отсутствует username или password" << std::endl;
+        return reply(StaticResponseId::MissingCredentials);
+    }
+
+    std::string username(creds.username.view());
+    std::string password(creds.password.view());
+
+    std::cout << "[LOGIN] Имя пользователя: " << username << std::endl;
+
+    User user;
+    if (!Database::getUser(username, user)) {
+        std::cerr << "[LOGIN] Пользователь не найден в базе данных" << std::endl;
+        return reply(StaticResponseId::InvalidCredentials);
+    }
+
+    auto verification = HashExecutor::verifyPassword(password, user.password);
+    if (!verification) {
+        std::cerr << "[LOGIN] Очередь хеширования переполнена" << std::endl;
+        return reply(StaticResponseId::ServerBusy);
+    }
+
+    if (!verification->get()) {
+        std::cerr << "[LOGIN] Неверный пароль" << std::endl;
+        return reply(StaticResponseId::InvalidCredentials);
+    }
+
+    // Хеш старого формата или устаревшей стоимости перехешируется в фоне:
+    // ответ клиенту не ждёт ни хеширования, ни записи.
+    if (PasswordEncryptor::needsRehash(user.password)) {
+        bool queued = HashExecutor::post([username, password] {
+            std::string upgraded = PasswordEncryptor::hashPassword(password);
+            WriteQueue::updatePassword(username, upgraded);
+            std::cout << "[LOGIN] Хеш пароля пользователя " << username << " обновлён до текущей схемы" << std::endl;
+        });
+        if (!queued)
+            std::cout << "[LOGIN] Перехеширование отложено до следующего входа (очередь заполнена)" << std::endl;
+    }
+
+    const RSAPrivateKey* privKey = AuthMiddleware::signingKey();
+    if (!privKey) {
+        std::cerr << "[LOGIN] Ключи не загружены" << std::endl;
+        return reply(StaticResponseId::KeyError);
+    }
+
+    TokenPair tokens = JWT::issuePair(username, 60 * 1, 60 * 60, *privKey);   // 1 минута / 60 минут
+
+    std::cout << "[LOGIN] Сгенерирован Access токен:" << std::endl << tokens.accessToken << std::endl;
+    std::cout << "[LOGIN] Сгенерирован Refresh токен:" << std::endl << tokens.refreshToken << std::endl;
+
+    std::string response = "{";
+    response += "\"access_token\":\"" + tokens.accessToken + "\",";
+    response += "\"refresh_token\":\"" + tokens.refreshToken + "\"";
+    response += "}";
+
+    res.set_content(response, "application/json");
+    std::cout << "[LOGIN] Ответ отправлен клиенту\n" << std::endl;
+    return nullptr;
+}
+
+/**
+ * @brief POST /refresh — новый access токен по refresh токену.
+ */
+static const StaticResponse* handleRefresh(const httplib::Request&, const AuthContext& auth, httplib::Response& res) {
+    std::cout << "\n[SERVER] --- /refresh endpoint called ---\n";
+    std::cout << "[JWT] Refresh token is valid.\n";
+    std::cout << "[JWT] Extracted subject (username): " << auth.subject << "\n";
+
+    if (Database::isTokenBlacklisted(std::string(auth.token))) {
+        std::cerr << "[SECURITY] Refresh token is blacklisted. Rejected.\n";
+        return reply(StaticResponseId::RefreshTokenBlacklisted);
+    }
+
+    std::cout << "[JWT] Token is not in blacklist. Proceeding to generate new access token...\n";
+
+    const RSAPrivateKey* privKey = AuthMiddleware::signingKey();
+    if (!privKey) {
+        std::cerr << "[ERROR] RSA keys are not loaded\n";
+        return reply(StaticResponseId::KeyError);
+    }
+
+    std::string newAccessToken = JWT::createAccessToken(auth.subject, 60, *privKey);  // 1 минута
+    std::cout << "[JWT] New access token generated:\n" << newAccessToken << "\n";
+
+    std::string response = "{";
+    response += "\"access_token\":\"" + newAccessToken + "\"";
+    response += "}";
+
+    std::cout << "[RESPONSE] JSON: " << response << "\n";
+    std::cout << "[SERVER] --- /refresh complete ---\n";
+
+    res.set_content(response, "application/json");
+    return nullptr;
+}
+
+/**
+ * @brief GET /secure/data — защищённые данные по access токену.
+ */
+static const StaticResponse* handleSecureData(const httplib::Request&, const AuthContext& auth, httplib::Response& res) {
+    std::cout << "\n[SERVER] --- /secure/data endpoint called ---\n";
+    std::cout << "[JWT] Access token is valid.\n";
+    std::cout << "[JWT] Extracted subject (username): " << auth.subject << "\n";
+
+    std::string secureData = "{ \"data\": \"Secret message for ";
+    Json::escape(auth.subject, secureData);
+    secureData += "\" }";
+    std::cout << "[RESPONSE] Sending secure data: " << secureData << "\n";
+    std::cout << "[SERVER] --- /secure/data complete ---\n";
+
+    res.set_content(secureData, "application/json");
+    return nullptr;
+}
+
+/**
+ * @brief POST /logout — отзыв refresh токена.
+ */
+static const StaticResponse* handleLogout(const httplib::Request&, const AuthContext& auth, httplib::Response&) {
+    std::cout << "\n[SERVER] --- /logout endpoint called ---\n";
+    std::cout << "[JWT] Token is valid. Subject: " << auth.subject << "\n";
+    std::cout << "[BLACKLIST] Extracted exp time: " << auth.expiresAt << "\n";
+
+    if (!WriteQueue::blacklistToken(std::string(auth.token), auth.expiresAt).get()) {
+        std::cerr << "[ERROR] Failed to blacklist token\n";
+        return reply(StaticResponseId::DatabaseError);
+    }
+
+    std::cout << "[BLACKLIST] Token successfully blacklisted\n";
+    std::cout << "[SERVER] --- /logout completed ---\n";
+
+    return reply(StaticResponseId::LoggedOut);
+}
+
+/**
+ * @brief POST /introspect — проверка пакета токенов для шлюзов API.
+ *
+ * Подписи проверяются JWT::introspect() одним подготовленным ключом в потоке обработчика,
+ * отзыв действующих refresh токенов — одним Database::findBlacklisted().
+ */
+static const StaticResponse* handleIntrospect(const httplib::Request& req, const AuthContext&, httplib::Response& res) {
+    std::cout << "\n[SERVER] --- /introspect endpoint called ---\n";
+
+    std::vector<std::string> tokens;
+    IntrospectHandler handler(tokens);
+    bool parsed = Json::parseObject(req.body, handler);
+    if (handler.list.tooMany) {
+        std::cerr << "[INTROSPECT] Токенов больше " << MAX_INTROSPECT_TOKENS << "\n";
+        return reply(StaticResponseId::TooManyTokens);
+    }
+    if (!parsed || !handler.found) {
+        std::cerr << "[INTROSPECT] Тело должно быть вида {\"tokens\": [...]}\n";
+        return reply(StaticResponseId::InvalidIntrospectRequest);
+    }
+
+    const RSAPublicKey* pubKey = AuthMiddleware::verificationKey();
+    if (!pubKey) {
+        std::cerr << "[INTROSPECT] Ключи не загружены\n";
+        return reply(StaticResponseId::KeyError);
+    }
+
+    std::vector<std::string_view> views(tokens.begin(), tokens.end());
+    std::vector<TokenIntrospection> results = JWT::introspect(views, *pubKey);
+
+    // Отзываются только refresh токены (/logout): проверяем действующие одним проходом.
+    std::vector<std::string> refreshTokens;
+    std::vector<size_t> refreshIdx;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].active && results[i].kind == TokenKind::Refresh) {
+            refreshTokens.push_back(tokens[i]);
+            refreshIdx.push_back(i);
         }
-    
-        std::string accessToken = authHeader.substr(7);
-        std::cout << "[TOKEN] Extracted access token: " << accessToken << "\n";
-    
-        // [2] Загружаем ключи
-        RSAPublicKey pubKey;
-        RSAPrivateKey privKey; // не нужен здесь, но оставим на случай доработок
-        if (!KeyStorage::loadKeys(pubKey, privKey)) {
-            std::cerr << "[ERROR] Failed to load RSA keys\n";
-            res.status = 500;
-            res.set_content("Key error", "text/plain");
-            return;
+    }
+    std::vector<bool> found;
+    if (!refreshTokens.empty() && !Database::findBlacklisted(refreshTokens, found)) {
+        std::cerr << "[INTROSPECT] Ошибка проверки blacklist\n";
+        return reply(StaticResponseId::DatabaseError);
+    }
+    std::vector<bool> revoked(results.size(), false);
+    for (size_t j = 0; j < refreshIdx.size(); ++j) revoked[refreshIdx[j]] = found[j];
+
+    std::string response = "{\"results\":[";
+    size_t active = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const TokenIntrospection& result = results[i];
+        if (i > 0) response += ',';
+        if (revoked[i]) {
+            response += "{\"active\":false,\"revoked\":true}";
+            continue;
         }
-    
-        // [3] Проверяем токен
-        std::string subject;
-        std::cout << "[VERIFY] Verifying access token...\n";
-        if (!JWT::verifyAccessToken(accessToken, pubKey, subject)) {
-            std::cerr << "[ERROR] Invalid or expired access token\n";
-            res.status = 401;
-            res.set_content("Invalid or expired access token", "text/plain");
-            return;
+        if (!result.active) {
+            response += "{\"active\":false}";
+            continue;
         }
-    
-        std::cout << "[JWT] Access token is valid.\n";
-        std::cout << "[JWT] Extracted subject (username): " << subject << "\n";
-    
-        // [4] Возвращаем защищённые данные
-        std::string secureData = "{ \"data\": \"Secret message for " + subject + "\" }";
-        std::cout << "[RESPONSE] Sending secure data: " << secureData << "\n";
-        std::cout << "[SERVER] --- /secure/data complete ---\n";
-    
-        res.set_content(secureData, "application/json");
+        active++;
+        response += "{\"active\":true,\"kind\":\"";
+        response += result.kind == TokenKind::Access ? TokenTraits<TokenKind::Access>::typ
+                                                     : TokenTraits<TokenKind::Refresh>::typ;
+        response += "\",\"sub\":\"";
+        Json::escape(result.subject, response);
+        response += "\",\"exp\":";
+        response += std::to_string(result.expiresAt);
+        response += '}';
+    }
+    response += "]}";
+
+    std::cout << "[INTROSPECT] Токенов: " << results.size() << ", действующих: " << active << "\n";
+    std::cout << "[SERVER] --- /introspect complete ---\n";
+
+    res.set_content(response, "application/json");
+    return nullptr;
+}
+
+/**
+ * @brief GET /.well-known/jwks.json — открытые ключи для локальной проверки токенов.
+ */
+static const StaticResponse* handleJwks(const httplib::Request& req, const AuthContext&, httplib::Response&) {
+    if (const StaticResponse* document = Jwks::respond(req)) return document;
+    std::cerr << "[JWKS] Ключи не загружены" << std::endl;
+    return reply(StaticResponseId::KeyError);
+}
+
+/**
+ * @brief GET /metrics — счётчики и гистограммы в текстовом формате Prometheus.
+ *
+ * Помимо Metrics выводит счётчики, которые модули уже ведут сами.
+ */
+static const StaticResponse* handleMetrics(const httplib::Request&, const AuthContext&, httplib::Response& res) {
+    std::string out;
+    out.reserve(16 * 1024);
+    Metrics::render(out);
+
+    TokenCacheStats tokens = TokenCache::getStats();
+    Metrics::appendValue(out, "jwt_token_cache_hits_total", "counter",
+                         "Access tokens found in TokenCache.", tokens.hits);
+    Metrics::appendValue(out, "jwt_token_cache_misses_total", "counter",
+                         "Access tokens verified in full.", tokens.misses);
+    Metrics::appendValue(out, "jwt_token_cache_evictions_total", "counter",
+                         "TokenCache LRU evictions.", tokens.evictions);
+
+    UserCacheStats users = UserCache::getStats();
+    Metrics::appendValue(out, "jwt_user_cache_hits_total", "counter",
+                         "Users found in UserCache.", users.hits + users.negativeHits);
+    Metrics::appendValue(out, "jwt_user_cache_misses_total", "counter",
+                         "User lookups that reached storage.", users.misses);
+
+    HashExecutorStats hashing = HashExecutor::getStats();
+    Metrics::appendValue(out, "jwt_hash_tasks_total", "counter",
+                         "Password hashing tasks completed.", hashing.completed);
+    Metrics::appendValue(out, "jwt_hash_rejected_total", "counter",
+                         "Password hashing tasks rejected (queue full).", hashing.rejected);
+    Metrics::appendValue(out, "jwt_hash_queue_wait_microseconds_total", "counter",
+                         "Time hashing tasks waited in the queue.", hashing.queueWaitMicros);
+    Metrics::appendValue(out, "jwt_hash_work_microseconds_total", "counter",
+                         "Time spent hashing passwords.", hashing.workMicros);
+
+    WriteQueueStats writes = WriteQueue::getStats();
+    Metrics::appendValue(out, "jwt_write_queue_ops_total", "counter", "Storage writes enqueued.", writes.enqueued);
+    Metrics::appendValue(out, "jwt_write_queue_batches_total", "counter", "Write batches committed.", writes.batches);
+    Metrics::appendValue(out, "jwt_write_queue_failed_batches_total", "counter",
+                         "Write batches that failed to commit.", writes.failedBatches);
+    Metrics::appendValue(out, "jwt_write_queue_commit_microseconds_total", "counter",
+                         "Time spent applying write batches.", writes.commitMicros);
+
+    BlacklistCleanerStats cleaner = BlacklistCleaner::getStats();
+    Metrics::appendValue(out, "jwt_blacklist_purged_total", "counter",
+                         "Expired revoked tokens deleted.", cleaner.rowsPurged);
+    Metrics::appendValue(out, "jwt_blacklist_cleaner_errors_total", "counter",
+                         "Purge batches that failed.", cleaner.errors);
+
+    RateLimiterStats limits = RateLimiter::getStats();
+    Metrics::appendValue(out, "jwt_rate_limited_total", "counter", "Requests rejected with 429.", limits.limited);
+    Metrics::appendValue(out, "jwt_rate_limit_buckets", "gauge", "Token buckets currently tracked.", limits.buckets);
+
+    res.set_content(out, "text/plain; version=0.0.4");
+    return nullptr;
+}
+
+const std::vector<Route>& HttpServer::routes() {
+    static const std::vector<Route> table = {
+        {"OPTIONS", "*",                      handleOptions,    false, AuthRequirement::None,         RateLimitScope::None},
+        {"POST",    "/register",              handleRegister,   true,  AuthRequirement::None,         RateLimitScope::Register},
+        {"POST",    "/login",                 handleLogin,      true,  AuthRequirement::None,         RateLimitScope::Login},
+        {"POST",    "/refresh",               handleRefresh,    true,  AuthRequirement::RefreshToken, RateLimitScope::None},
+        {"GET",     "/secure/data",           handleSecureData, false, AuthRequirement::AccessToken,  RateLimitScope::None},
+        {"POST",    "/logout",                handleLogout,     true,  AuthRequirement::RefreshToken, RateLimitScope::None},
+        {"POST",    "/introspect",            handleIntrospect, true,  AuthRequirement::None,         RateLimitScope::None},
+        {"GET",     "/.well-known/jwks.json", handleJwks,       false, AuthRequirement::None,         RateLimitScope::None},
+        {"GET",     "/metrics",               handleMetrics,    false, AuthRequirement::None,         RateLimitScope::None},
+    };
+    return table;
+}
+
+const Route* HttpServer::findRoute(std::string_view method, std::string_view path) {
+    for (const Route& route : routes()) {
+        if (method == route.method && (path == route.path || std::string_view(route.path) == "*"))
+            return &route;
+    }
+    return nullptr;
+}
+
+const StaticResponse* HttpServer::admit(const Route& route, const httplib::Request& req, AuthContext& auth) {
+    if (const StaticResponse* limited = RateLimiter::admit(route.limit, req)) return limited;
+    return AuthMiddleware::authenticate(route.auth, req, auth);
+}
+
+const StaticResponse* HttpServer::dispatch(const Route& route, const httplib::Request& req, httplib::Response& res) {
+    AuthContext auth;
+    if (const StaticResponse* denied = admit(route, req, auth)) return denied;
+    return route.handler(req, auth, res);
+}
+
+const StaticResponse* HttpServer::dispatch(const Route& route, const httplib::Request& req, const AuthContext& auth,
+                                           httplib::Response& res) {
+    return route.handler(req, auth, res);
+}
+
+/**
+ * @brief Пишет строку в лог и учитывает запрос в Metrics.
+ *
+ * @param start Момент разбора запроса; steady_clock::time_point::min() — неизвестен.
+ */
+static void observe(const httplib::Request& req, int status, std::chrono::steady_clock::time_point start) {
+    std::cout << "[LOGGER] " << req.method << " " << req.path << " -> " << status << "\n";
+
+    const Route* route = HttpServer::findRoute(req.method, req.path);
+    size_t index = route ? static_cast<size_t>(route - HttpServer::routes().data()) : HttpServer::routes().size();
+    uint64_t nanos = Metrics::UNTIMED;
+    if (start != std::chrono::steady_clock::time_point::min()) {
+        nanos = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    Metrics::recordRequest(index, status, nanos);
+}
+
+void HttpServer::logRequest(const httplib::Request& req, int status) {
+    observe(req, status, req.start_time_);
+}
+
+/**
+ * @brief Начало текущего запроса httplib: поток обрабатывает запросы соединения по одному.
+ */
+static thread_local std::chrono::steady_clock::time_point httplib_request_start =
+    std::chrono::steady_clock::time_point::min();
+
+static std::mutex running_mutex;
+static httplib::Server* running_server = nullptr;   ///< Сервер движка httplib, пока он принимает соединения.
+static bool shutdown_requested = false;             ///< Был вызван shutdown() (под running_mutex).
+
+bool HttpServer::start(const HttpSettings& settings) {
+    StaticResponses::prepare();
+    AuthMiddleware::configure();
+    RateLimiter::configure(settings.rateLimits);
+
+    std::vector<std::string> metricLabels;
+    for (const Route& route : routes())
+        metricLabels.push_back(std::string("method=\"") + route.method + "\",route=\"" + route.path + "\"");
+    metricLabels.push_back("method=\"\",route=\"unmatched\"");
+    Metrics::setRoutes(metricLabels);
+
+    if (settings.engine == HttpEngine::Epoll)
+        return EpollServer::run(settings);
+    if (settings.engine == HttpEngine::Uring)
+        return UringServer::run(settings);
+
+    httplib::Server server;
+
+    // Потоки, ожидающие HashExecutor, не должны отнимать обработчики у остальных маршрутов:
+    // пул HTTP расширяется на максимальное число принятых задач хеширования.
+    size_t baseWorkers = settings.workers ? settings.workers : CPPHTTPLIB_THREAD_POOL_COUNT;
+    size_t workerCount = baseWorkers + HashExecutor::capacity();
+    size_t maxQueued = settings.maxQueuedRequests;
+    server.new_task_queue = [workerCount, maxQueued] { return new httplib::ThreadPool(workerCount, maxQueued); };
+
+    server.set_keep_alive_max_count(settings.keepAliveMaxCount);
+    server.set_keep_alive_timeout(settings.keepAliveTimeoutSec);
+    server.set_read_timeout(settings.readTimeoutSec, 0);
+    server.set_write_timeout(settings.writeTimeoutSec, 0);
+    server.set_payload_max_length(settings.payloadMaxBytes);
+
+    // httplib вызывает listen() с CPPHTTPLIB_LISTEN_BACKLOG; запоминаем сокет,
+    // чтобы после bind задать backlog из настроек (повторный listen() меняет его).
+    socket_t listenSocket = INVALID_SOCKET;
+    server.set_socket_options([&listenSocket](socket_t sock) {
+        httplib::default_socket_options(sock);
+        listenSocket = sock;
     });
-    
-    server.Post("/logout", [](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        std::cout << "\n[SERVER] --- /logout endpoint called ---\n";
-    
-        if (!req.has_header("Authorization")) {
-            std::cerr << "[ERROR] Missing Authorization header\n";
-            res.status = 400;
-            res.set_content("Missing Authorization header", "text/plain");
-            return;
-        }
-    
-        std::string authHeader = req.get_header_value("Authorization");
-        std::cout << "[HEADER] Authorization: " << authHeader << "\n";
-    
-        std::string prefix = "Bearer ";
-        if (authHeader.rfind(prefix, 0) != 0) {
-            std::cerr << "[ERROR] Authorization header must start with 'Bearer '\n";
-            res.status = 400;
-            res.set_content("Invalid Authorization header format", "text/plain");
-            return;
-        }
-    
-        std::string refreshToken = authHeader.substr(prefix.size());
-        std::cout << "[INPUT] Extracted refresh token: " << refreshToken << "\n";
-    
-        RSAPublicKey pubKey;
-        RSAPrivateKey privKey;
-        if (!KeyStorage::loadKeys(pubKey, privKey)) {
-            std::cerr << "[ERROR] Failed to load keys\n";
-            res.status = 500;
-            res.set_content("Key error", "text/plain");
-            return;
-        }
-    
-        std::string subject;
-        std::cout << "[VERIFY] Verifying refresh token...\n";
-    
-        if (!JWT::verifyRefreshToken(refreshToken, pubKey, subject)) {
-            std::cerr << "[ERROR] Invalid or expired refresh token\n";
-            res.status = 401;
-            res.set_content("Invalid or expired refresh token", "text/plain");
-            return;
-        }
-    
-        std::cout << "[JWT] Token is valid. Subject: " << subject << "\n";
-    
-        // ====== Вытаскиваем expires_at из payload ======
-        std::string payloadB64 = refreshToken.substr(
-            refreshToken.find('.') + 1,
-            refreshToken.rfind('.') - refreshToken.find('.') - 1
-        );
-        std::string payloadJson = Base64URL::decode(payloadB64);
-    
-        size_t expPos = payloadJson.find("\"exp\":");
-        if (expPos == std::string::npos) {
-            std::cerr << "[ERROR] Cannot extract exp from token\n";
-            res.status = 400;
-            res.set_content("Invalid token payload", "text/plain");
-            return;
-        }
-    
-        expPos += 6;
-        size_t expEnd = payloadJson.find_first_of(",}", expPos);
-        uint64_t expTime = std::stoull(payloadJson.substr(expPos, expEnd - expPos));
-    
-        std::cout << "[BLACKLIST] Extracted exp time: " << expTime << "\n";
-    
-        if (!Database::blacklistToken(refreshToken, expTime)) {
-            std::cerr << "[ERROR] Failed to blacklist token\n";
-            res.status = 500;
-            res.set_content("Database error", "text/plain");
-            return;
-        }
-    
-        std::cout << "[BLACKLIST] Token successfully blacklisted\n";
-        std::cout << "[SERVER] --- /logout completed ---\n";
-    
-        res.set_content("Logged out successfully", "text/plain");
-    });            
-
-    std::cout << "[HttpServer] Сервер запущен на порту " << port << std::endl;
-    server.listen("0.0.0.0", port);
+
+    server.set_pre_routing_handler([](const httplib::Request&, httplib::Response&) {
+        httplib_request_start = std::chrono::steady_clock::now();
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+    server.set_logger([](const httplib::Request& req, const httplib::Response& res) {
+        observe(req, res.status, httplib_request_start);
+        httplib_request_start = std::chrono::steady_clock::time_point::min();
+    });
+    server.set_default_headers(StaticResponses::commonHeaders());
+
+    for (const Route& route : routes()) {
+        std::string method = route.method;
+        std::string pattern = (std::string_view(route.path) == "*") ? ".*" : route.path;
+        auto adapter = [&route](const httplib::Request& req, httplib::Response& res) {
+            if (const StaticResponse* fixed = dispatch(route, req, res)) StaticResponses::apply(*fixed, res);
+        };
+        if (method == "GET") server.Get(pattern, adapter);
+        else if (method == "POST") server.Post(pattern, adapter);
+        else if (method == "OPTIONS") server.Options(pattern, adapter);
+    }
+
+    if (!server.bind_to_port(settings.host, settings.port)) {
+        std::cerr << "[HttpServer] Не удалось занять " << settings.host << ":" << settings.port << std::endl;
+        return false;
+    }
+    if (::listen(listenSocket, settings.listenBacklog) != 0)
+        std::cerr << "[HttpServer] Не удалось установить listen backlog " << settings.listenBacklog << std::endl;
+
+    {
+        std::lock_guard<std::mutex> lock(running_mutex);
+        if (shutdown_requested) return true;
+        running_server = &server;
+    }
+
+    std::cout << "[HttpServer] Сервер запущен на " << settings.host << ":" << settings.port << ", обработчиков "
+              << workerCount << ", очередь до " << maxQueued << std::endl;
+    bool listened = server.listen_after_bind();
+    std::cout << "[HttpServer] Остановлен" << std::endl;
+
+    std::lock_guard<std::mutex> lock(running_mutex);
+    running_server = nullptr;
+    return listened;
+}
+
+void HttpServer::shutdown(std::chrono::seconds timeout) {
+    std::lock_guard<std::mutex> lock(running_mutex);
+    if (shutdown_requested) return;
+    shutdown_requested = true;
+
+    // UringServer без io_uring запускает EpollServer, поэтому останавливаются оба.
+    EpollServer::drain(timeout);
+    UringServer::drain(timeout);
+
+    if (running_server) {
+        // stop() до начала listen ничего не делает. Закрытый слушающий сокет завершает
+        // keep-alive ожидание httplib, а пул дожидается начатых запросов.
+        running_server->wait_until_ready();
+        running_server->stop();
+    }
 }
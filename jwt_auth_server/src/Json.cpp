@@ -0,0 +1,374 @@
+#include "../include/Json.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+    /**
+     * @brief Курсор по входной строке.
+     */
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        bool atEnd() const { return p >= end; }
+        char peek() const { return p < end ? *p : '\0'; }
+
+        void skipWhitespace() {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+        }
+
+        bool consume(char c) {
+            if (p < end && *p == c) { ++p; return true; }
+            return false;
+        }
+
+        bool consumeLiteral(std::string_view literal) {
+            if (static_cast<size_t>(end - p) < literal.size()) return false;
+            if (std::string_view(p, literal.size()) != literal) return false;
+            p += literal.size();
+            return true;
+        }
+    };
+
+    /**
+     * @brief Таблица символов, прерывающих быстрый проход по строке: `"`, `\` и управляющие.
+     */
+    struct StringStopTable {
+        bool stop[256];
+
+        StringStopTable() {
+            for (int i = 0; i < 256; ++i) stop[i] = (i < 0x20 || i == '"' || i == '\\');
+        }
+    };
+
+    const StringStopTable string_stop;
+
+    bool isHexDigit(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+        return 10 + (c - 'A');
+    }
+
+    /**
+     * @brief Сканирует строку; курсор стоит после открывающей кавычки.
+     *
+     * @param[out] raw Содержимое между кавычками.
+     * @param[out] escaped Встретился ли `\`.
+     */
+    bool scanString(Cursor& c, std::string_view& raw, bool& escaped) {
+        const char* start = c.p;
+        escaped = false;
+        while (!c.atEnd()) {
+            // Обычные символы пропускаются одним плотным циклом.
+            while (c.p < c.end && !string_stop.stop[static_cast<unsigned char>(*c.p)]) ++c.p;
+            if (c.atEnd()) return false;
+
+            char ch = *c.p;
+            if (ch == '"') {
+                raw = std::string_view(start, static_cast<size_t>(c.p - start));
+                ++c.p;
+                return true;
+            }
+            if (static_cast<unsigned char>(ch) < 0x20) return false;
+            if (ch == '\\') {
+                escaped = true;
+                ++c.p;
+                if (c.atEnd()) return false;
+                char e = *c.p;
+                if (e == 'u') {
+                    if (c.end - c.p < 5) return false;
+                    for (int i = 1; i <= 4; ++i)
+                        if (!isHexDigit(c.p[i])) return false;
+                    c.p += 4;
+                } else if (e != '"' && e != '\\' && e != '/' && e != 'b' && e != 'f' &&
+                           e != 'n' && e != 'r' && e != 't') {
+                    return false;
+                }
+            }
+            ++c.p;
+        }
+        return false;
+    }
+
+    bool scanNumber(Cursor& c) {
+        const char* start = c.p;
+        c.consume('-');
+        if (c.consume('0')) {
+            // ведущий ноль не может быть продолжен цифрами
+        } else {
+            if (c.peek() < '1' || c.peek() > '9') return false;
+            while (c.peek() >= '0' && c.peek() <= '9') ++c.p;
+        }
+        if (c.consume('.')) {
+            if (c.peek() < '0' || c.peek() > '9') return false;
+            while (c.peek() >= '0' && c.peek() <= '9') ++c.p;
+        }
+        if (c.peek() == 'e' || c.peek() == 'E') {
+            ++c.p;
+            if (c.peek() == '+' || c.peek() == '-') ++c.p;
+            if (c.peek() < '0' || c.peek() > '9') return false;
+            while (c.peek() >= '0' && c.peek() <= '9') ++c.p;
+        }
+        return c.p > start;
+    }
+
+    const int MAX_DEPTH = 32;
+
+    bool scanValue(Cursor& c, JsonType& type, bool& escaped, std::string_view& raw, int depth);
+
+    /**
+     * @brief Пропускает вложенный объект или массив; курсор стоит на открывающей скобке.
+     */
+    bool skipContainer(Cursor& c, int depth) {
+        if (depth > MAX_DEPTH) return false;
+        char close = (*c.p == '{') ? '}' : ']';
+        bool isObject = (close == '}');
+        ++c.p;
+
+        c.skipWhitespace();
+        if (c.consume(close)) return true;
+
+        while (true) {
+            c.skipWhitespace();
+            if (isObject) {
+                std::string_view key;
+                bool keyEscaped;
+                if (!c.consume('"') || !scanString(c, key, keyEscaped)) return false;
+                c.skipWhitespace();
+                if (!c.consume(':')) return false;
+                c.skipWhitespace();
+            }
+
+            JsonType type;
+            bool escaped;
+            std::string_view raw;
+            if (!scanValue(c, type, escaped, raw, depth + 1)) return false;
+
+            c.skipWhitespace();
+            if (c.consume(',')) continue;
+            return c.consume(close);
+        }
+    }
+
+    bool scanValue(Cursor& c, JsonType& type, bool& escaped, std::string_view& raw, int depth) {
+        escaped = false;
+        const char* start = c.p;
+        char ch = c.peek();
+
+        if (ch == '"') {
+            ++c.p;
+            type = JsonType::String;
+            return scanString(c, raw, escaped);
+        }
+        if (ch == '-' || (ch >= '0' && ch <= '9')) {
+            type = JsonType::Number;
+            if (!scanNumber(c)) return false;
+        } else if (ch == 't') {
+            type = JsonType::True;
+            if (!c.consumeLiteral("true")) return false;
+        } else if (ch == 'f') {
+            type = JsonType::False;
+            if (!c.consumeLiteral("false")) return false;
+        } else if (ch == 'n') {
+            type = JsonType::Null;
+            if (!c.consumeLiteral("null")) return false;
+        } else if (ch == '{' || ch == '[') {
+            type = (ch == '{') ? JsonType::Object : JsonType::Array;
+            if (!skipContainer(c, depth)) return false;
+        } else {
+            return false;
+        }
+
+        raw = std::string_view(start, static_cast<size_t>(c.p - start));
+        return true;
+    }
+
+    bool appendUtf8(uint32_t cp, char* out, size_t capacity, size_t& len) {
+        char buf[4];
+        size_t n;
+        if (cp < 0x80) {
+            buf[0] = static_cast<char>(cp);
+            n = 1;
+        } else if (cp < 0x800) {
+            buf[0] = static_cast<char>(0xC0 | (cp >> 6));
+            buf[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            n = 2;
+        } else if (cp < 0x10000) {
+            buf[0] = static_cast<char>(0xE0 | (cp >> 12));
+            buf[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            buf[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            n = 3;
+        } else {
+            buf[0] = static_cast<char>(0xF0 | (cp >> 18));
+            buf[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            buf[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            buf[3] = static_cast<char>(0x80 | (cp & 0x3F));
+            n = 4;
+        }
+        if (len + n > capacity) return false;
+        for (size_t i = 0; i < n; ++i) out[len++] = buf[i];
+        return true;
+    }
+
+    uint32_t readHex4(const char* p) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v = (v << 4) | static_cast<uint32_t>(hexValue(p[i]));
+        return v;
+    }
+}
+
+bool Json::parseObject(std::string_view json, JsonHandler& handler) {
+    Cursor c{json.data(), json.data() + json.size()};
+
+    c.skipWhitespace();
+    if (!c.consume('{')) return false;
+    c.skipWhitespace();
+
+    if (!c.consume('}')) {
+        while (true) {
+            c.skipWhitespace();
+
+            JsonField field;
+            bool keyEscaped;
+            if (!c.consume('"') || !scanString(c, field.key, keyEscaped)) return false;
+
+            c.skipWhitespace();
+            if (!c.consume(':')) return false;
+            c.skipWhitespace();
+
+            if (!scanValue(c, field.type, field.hasEscapes, field.raw, 1)) return false;
+            if (!handler.onField(field)) return false;
+
+            c.skipWhitespace();
+            if (c.consume(',')) continue;
+            if (c.consume('}')) break;
+            return false;
+        }
+    }
+
+    c.skipWhitespace();
+    return c.atEnd();
+}
+
+bool Json::parseArray(std::string_view json, JsonHandler& handler) {
+    Cursor c{json.data(), json.data() + json.size()};
+
+    c.skipWhitespace();
+    if (!c.consume('[')) return false;
+    c.skipWhitespace();
+
+    if (!c.consume(']')) {
+        while (true) {
+            c.skipWhitespace();
+
+            JsonField element;
+            if (!scanValue(c, element.type, element.hasEscapes, element.raw, 1)) return false;
+            if (!handler.onField(element)) return false;
+
+            c.skipWhitespace();
+            if (c.consume(',')) continue;
+            if (c.consume(']')) break;
+            return false;
+        }
+    }
+
+    c.skipWhitespace();
+    return c.atEnd();
+}
+
+bool Json::unescape(std::string_view raw, char* out, size_t capacity, size_t& outLen) {
+    outLen = 0;
+
+    // Строки без `\` (почти все) копируются целиком.
+    const void* backslash = std::memchr(raw.data(), '\\', raw.size());
+    size_t plain = backslash ? static_cast<size_t>(static_cast<const char*>(backslash) - raw.data()) : raw.size();
+    if (plain > capacity) return false;
+    std::memcpy(out, raw.data(), plain);
+    outLen = plain;
+
+    for (size_t i = plain; i < raw.size(); ++i) {
+        char ch = raw[i];
+        if (ch != '\\') {
+            if (outLen >= capacity) return false;
+            out[outLen++] = ch;
+            continue;
+        }
+
+        if (++i >= raw.size()) return false;
+        char e = raw[i];
+        char decoded;
+        switch (e) {
+            case '"':  decoded = '"'; break;
+            case '\\': decoded = '\\'; break;
+            case '/':  decoded = '/'; break;
+            case 'b':  decoded = '\b'; break;
+            case 'f':  decoded = '\f'; break;
+            case 'n':  decoded = '\n'; break;
+            case 'r':  decoded = '\r'; break;
+            case 't':  decoded = '\t'; break;
+            case 'u': {
+                if (i + 4 >= raw.size()) return false;
+                for (size_t k = 1; k <= 4; ++k)
+                    if (!isHexDigit(raw[i + k])) return false;
+                uint32_t cp = readHex4(raw.data() + i + 1);
+                i += 4;
+
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // Старшая половина суррогатной пары — ожидаем \uDC00..\uDFFF.
+                    if (i + 6 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u') return false;
+                    for (size_t k = 3; k <= 6; ++k)
+                        if (!isHexDigit(raw[i + k])) return false;
+                    uint32_t low = readHex4(raw.data() + i + 3);
+                    if (low < 0xDC00 || low > 0xDFFF) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+
+                if (!appendUtf8(cp, out, capacity, outLen)) return false;
+                continue;
+            }
+            default:
+                return false;
+        }
+
+        if (outLen >= capacity) return false;
+        out[outLen++] = decoded;
+    }
+    return true;
+}
+
+void Json::escape(std::string_view in, std::string& out) {
+    static const char* hex = "0123456789abcdef";
+    for (char ch : in) {
+        switch (ch) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    out += "\\u00";
+                    out += hex[(ch >> 4) & 0x0F];
+                    out += hex[ch & 0x0F];
+                } else {
+                    out += ch;
+                }
+        }
+    }
+}
+
+bool Json::toUint(const JsonField& field, uint64_t& out) {
+    if (field.type != JsonType::Number) return false;
+    const char* begin = field.raw.data();
+    const char* end = begin + field.raw.size();
+    auto result = std::from_chars(begin, end, out);
+    return result.ec == std::errc() && result.ptr == end;
+}
@@ -0,0 +1,116 @@
+#include "../include/Jwks.h"
+#include "../include/Base64URL.h"
+#include "../include/SHA256.h"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    const char* CACHE_CONTROL = "public, max-age=300";   ///< Сколько проверяющие могут не перезапрашивать ключи.
+
+    /**
+     * @brief Опубликованный набор ключей с готовыми ответами.
+     */
+    struct Document {
+        std::string etag;
+        StaticResponse ok;            ///< 200 с телом JWKS.
+        StaticResponse notModified;   ///< 304 с тем же ETag.
+    };
+
+    // Документы не освобождаются: ключи меняются редко, а ответ из старого
+    // документа может ещё дописываться в буфер соединения.
+    std::mutex publish_mutex;
+    std::vector<std::unique_ptr<Document>> documents;
+    std::atomic<const Document*> current{nullptr};
+
+    /**
+     * @brief Base64URL от big-endian записи числа без ведущих нулей (RFC 7518, 6.3.1).
+     */
+    bool encodeUnsigned(const BigInt& value, std::string& out) {
+        if (value.isNegative() || value.isZero()) return false;
+
+        // Десятичная запись из d цифр занимает не больше d / 2 + 1 байт.
+        size_t capacity = value.toString().size() / 2 + 1;
+        std::vector<uint8_t> bytes(capacity);
+        if (!value.toBytes(bytes.data(), capacity)) return false;
+
+        size_t first = 0;
+        while (first + 1 < capacity && bytes[first] == 0) ++first;
+        Base64URL::encode(std::string_view(reinterpret_cast<const char*>(bytes.data()) + first, capacity - first), out);
+        return true;
+    }
+
+    /**
+     * @brief Есть ли etag в значении If-None-Match (`*` или список, слабые метки сравниваются слабо).
+     */
+    bool matchesIfNoneMatch(const std::string& header, const std::string& etag) {
+        size_t pos = 0;
+        while (pos < header.size()) {
+            size_t comma = header.find(',', pos);
+            if (comma == std::string::npos) comma = header.size();
+            std::string_view tag(header.data() + pos, comma - pos);
+            while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) tag.remove_prefix(1);
+            while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) tag.remove_suffix(1);
+            if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+            if (tag == "*" || tag == etag) return true;
+            pos = comma + 1;
+        }
+        return false;
+    }
+
+    StaticResponse prepare(int status, const std::string& body, const std::string& etag) {
+        return StaticResponses::make(status, body, "application/json",
+                                     {{"ETag", etag}, {"Cache-Control", CACHE_CONTROL}});
+    }
+}
+
+std::string Jwks::thumbprint(const RSAPublicKey& pubKey) {
+    std::string e, n;
+    if (!encodeUnsigned(pubKey.e, e) || !encodeUnsigned(pubKey.n, n)) return std::string();
+
+    // Обязательные члены JWK в лексикографическом порядке, без пробелов.
+    std::string canonical = "{\"e\":\"" + e + "\",\"kty\":\"RSA\",\"n\":\"" + n + "\"}";
+    SHA256::Digest digest = SHA256::digest(canonical.data(), canonical.size());
+
+    std::string kid;
+    Base64URL::encode(std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size()), kid);
+    return kid;
+}
+
+bool Jwks::publish(const RSAPublicKey& pubKey) {
+    std::string e, n;
+    if (!encodeUnsigned(pubKey.e, e) || !encodeUnsigned(pubKey.n, n)) {
+        std::cerr << "[JWKS] Ключ нельзя опубликовать: e и n должны быть положительными" << std::endl;
+        return false;
+    }
+    std::string kid = thumbprint(pubKey);
+
+    std::string body = "{\"keys\":[{\"kty\":\"RSA\",\"use\":\"sig\",\"alg\":\"RS256\",\"kid\":\"" + kid +
+                       "\",\"n\":\"" + n + "\",\"e\":\"" + e + "\"}]}";
+
+    SHA256::Digest digest = SHA256::digest(body.data(), body.size());
+    auto document = std::make_unique<Document>();
+    document->etag = "\"" + SHA256::toHex(digest).substr(0, 32) + "\"";
+    document->ok = prepare(200, body, document->etag);
+    document->notModified = prepare(304, std::string(), document->etag);
+
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    current.store(document.get(), std::memory_order_release);
+    documents.push_back(std::move(document));
+
+    std::cout << "[JWKS] Опубликован ключ kid=" << kid << ", ETag " << documents.back()->etag << std::endl;
+    return true;
+}
+
+const StaticResponse* Jwks::respond(const httplib::Request& req) {
+    const Document* document = current.load(std::memory_order_acquire);
+    if (!document) return nullptr;
+
+    auto header = req.headers.find("If-None-Match");
+    if (header != req.headers.end() && matchesIfNoneMatch(header->second, document->etag))
+        return &document->notModified;
+    return &document->ok;
+}
@@ -0,0 +1,24 @@
+#include "../include/JwtView.h"
+
+bool JwtView::parse(std::string_view token, JwtView& out) {
+    size_t firstDot = token.find('.');
+    if (firstDot == std::string_view::npos) return false;
+
+    size_t secondDot = token.find('.', firstDot + 1);
+    if (secondDot == std::string_view::npos) return false;
+    if (token.find('.', secondDot + 1) != std::string_view::npos) return false;
+
+    out.header = token.substr(0, firstDot);
+    out.payload = token.substr(firstDot + 1, secondDot - firstDot - 1);
+    out.signature = token.substr(secondDot + 1);
+    out.signingInput = token.substr(0, secondDot);
+
+    return !out.header.empty() && !out.payload.empty() && !out.signature.empty();
+}
+
+bool JwtView::bearerToken(std::string_view authorization, std::string_view& token) {
+    constexpr std::string_view prefix = "Bearer ";
+    if (authorization.substr(0, prefix.size()) != prefix) return false;
+    token = authorization.substr(prefix.size());
+    return true;
+}
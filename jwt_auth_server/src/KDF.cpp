@@ -0,0 +1,142 @@
+#include "../include/KDF.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+    const size_t BLOCK_SIZE = 64;
+
+    /**
+     * @brief Контексты HMAC с уже поглощёнными (key ^ ipad) и (key ^ opad).
+     *
+     * PBKDF2 вычисляет HMAC тысячи раз с одним ключом, поэтому оба блока ключа
+     * поглощаются один раз, а на каждой итерации копируются готовые контексты.
+     */
+    struct HmacKey {
+        SHA256::Context inner;
+        SHA256::Context outer;
+
+        explicit HmacKey(const std::string& key) {
+            uint8_t block[BLOCK_SIZE] = {0};
+            if (key.size() > BLOCK_SIZE) {
+                SHA256::Digest d = SHA256::digest(key.data(), key.size());
+                std::memcpy(block, d.data(), d.size());
+            } else {
+                std::memcpy(block, key.data(), key.size());
+            }
+
+            uint8_t ipad[BLOCK_SIZE], opad[BLOCK_SIZE];
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                ipad[i] = block[i] ^ 0x36;
+                opad[i] = block[i] ^ 0x5c;
+            }
+            inner.update(ipad, BLOCK_SIZE);
+            outer.update(opad, BLOCK_SIZE);
+        }
+
+        SHA256::Digest mac(const void* data, size_t len) const {
+            SHA256::Context in = inner;
+            in.update(data, len);
+            SHA256::Digest innerDigest = in.finish();
+
+            SHA256::Context out = outer;
+            out.update(innerDigest.data(), innerDigest.size());
+            return out.finish();
+        }
+    };
+
+    void putCounter(SHA256::Context& ctx, uint64_t value) {
+        uint8_t bytes[8];
+        for (int i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(value >> (i * 8));
+        ctx.update(bytes, sizeof(bytes));
+    }
+
+    uint64_t digestToIndex(const SHA256::Digest& d) {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(d[i]) << (i * 8);
+        return v;
+    }
+}
+
+SHA256::Digest KDF::hmacSha256(const std::string& key, const std::string& data) {
+    return HmacKey(key).mac(data.data(), data.size());
+}
+
+SHA256::Digest KDF::pbkdf2Sha256(const std::string& password, const std::string& salt, uint32_t iterations) {
+    HmacKey key(password);
+
+    // U1 = HMAC(P, S || INT(1))
+    std::string first = salt;
+    first.append("\x00\x00\x00\x01", 4);
+    SHA256::Digest u = key.mac(first.data(), first.size());
+    SHA256::Digest result = u;
+
+    for (uint32_t i = 1; i < iterations; ++i) {
+        u = key.mac(u.data(), u.size());
+        for (size_t j = 0; j < result.size(); ++j) result[j] ^= u[j];
+    }
+
+    return result;
+}
+
+SHA256::Digest KDF::balloonSha256(const std::string& password, const std::string& salt,
+                                  uint32_t spaceCost, uint32_t timeCost) {
+    const uint32_t delta = 3;
+    if (spaceCost == 0) spaceCost = 1;
+    if (timeCost == 0) timeCost = 1;
+
+    std::vector<SHA256::Digest> buf(spaceCost);
+    uint64_t cnt = 0;
+
+    // Шаг 1: заполнение буфера.
+    {
+        SHA256::Context ctx;
+        putCounter(ctx, cnt++);
+        ctx.update(password.data(), password.size());
+        ctx.update(salt.data(), salt.size());
+        buf[0] = ctx.finish();
+    }
+    for (uint32_t m = 1; m < spaceCost; ++m) {
+        SHA256::Context ctx;
+        putCounter(ctx, cnt++);
+        ctx.update(buf[m - 1].data(), buf[m - 1].size());
+        buf[m] = ctx.finish();
+    }
+
+    // Шаг 2: перемешивание с псевдослучайными (зависящими только от соли) обращениями к памяти.
+    for (uint32_t t = 0; t < timeCost; ++t) {
+        for (uint32_t m = 0; m < spaceCost; ++m) {
+            const SHA256::Digest& prev = buf[(m + spaceCost - 1) % spaceCost];
+            {
+                SHA256::Context ctx;
+                putCounter(ctx, cnt++);
+                ctx.update(prev.data(), prev.size());
+                ctx.update(buf[m].data(), buf[m].size());
+                buf[m] = ctx.finish();
+            }
+
+            for (uint32_t i = 0; i < delta; ++i) {
+                SHA256::Context idxBlock;
+                putCounter(idxBlock, t);
+                putCounter(idxBlock, m);
+                putCounter(idxBlock, i);
+                SHA256::Digest idx = idxBlock.finish();
+
+                SHA256::Context otherCtx;
+                putCounter(otherCtx, cnt++);
+                otherCtx.update(salt.data(), salt.size());
+                otherCtx.update(idx.data(), idx.size());
+                uint64_t other = digestToIndex(otherCtx.finish()) % spaceCost;
+
+                SHA256::Context ctx;
+                putCounter(ctx, cnt++);
+                ctx.update(buf[m].data(), buf[m].size());
+                ctx.update(buf[other].data(), buf[other].size());
+                buf[m] = ctx.finish();
+            }
+        }
+    }
+
+    // Шаг 3: результат — последний блок.
+    return buf[spaceCost - 1];
+}
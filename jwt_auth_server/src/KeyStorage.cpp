@@ -1,5 +1,6 @@
 #include "../include/KeyStorage.h"
 #include "../include/SHA256.h"
+#include "../include/Metrics.h"
 #include <fstream>
 #include <iostream>
 
@@ -23,6 +24,7 @@ void KeyStorage::saveKeys(const RSAPublicKey& pubKey, const RSAPrivateKey& privK
 }
 
 bool KeyStorage::loadKeys(RSAPublicKey& pubKey, RSAPrivateKey& privKey) {
+    StageTimer timer(MetricStage::KeyLoad);
     std::ifstream privIn(PRIV_FILE);
     std::ifstream pubIn(PUB_FILE);
 
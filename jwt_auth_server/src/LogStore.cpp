@@ -0,0 +1,285 @@
+#include "../include/LogStore.h"
+
+#include <ctime>
+#include <iostream>
+#include <mutex>
+
+namespace {
+    const uint32_t RECORD_USER = 1;
+    const uint32_t RECORD_REVOCATION = 2;
+}
+
+// ===========================
+// USERS
+// ===========================
+
+bool LogUserStore::open(const std::string& path, const LogStoreOptions& opts) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    options = opts;
+    index.clear();
+    liveBytes = 0;
+    nextId = 1;
+
+    bool ok = log.open(path, options.reserveBytes, [this](const MappedLog::Record& r, uint64_t offset) {
+        indexRecord(r, offset);
+    });
+    if (ok) {
+        std::cout << "[LogUserStore] Загружено пользователей: " << index.size()
+                  << " (" << log.size() << " байт журнала)" << std::endl;
+    }
+    return ok;
+}
+
+void LogUserStore::indexRecord(const MappedLog::Record& record, uint64_t offset) {
+    if (record.type != RECORD_USER) return;
+
+    auto it = index.find(record.key);
+    if (it != index.end()) {
+        liveBytes -= MappedLog::recordSize(log.at(it->second));
+        index.erase(it);
+    }
+    index.emplace(record.key, offset);
+    liveBytes += MappedLog::recordSize(record);
+
+    int id = static_cast<int>(record.num);
+    if (id >= nextId) nextId = id + 1;
+}
+
+bool LogUserStore::appendUser(const std::string& username, const std::string& passwordHash, int id) {
+    MappedLog::Record record;
+    record.type = RECORD_USER;
+    record.num = static_cast<uint64_t>(id);
+    record.key = username;
+    record.value = passwordHash;
+
+    uint64_t offset;
+    MappedLog::Record stored;
+    if (!log.append(record, offset, stored)) return false;
+    indexRecord(stored, offset);
+    return true;
+}
+
+bool LogUserStore::insertUser(const std::string& username, const std::string& passwordHash) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (index.count(username)) return false;
+    if (!appendUser(username, passwordHash, nextId)) return false;
+    return !options.syncOnCommit || log.sync();
+}
+
+LookupResult LogUserStore::findUser(const std::string& username, User& user_out) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = index.find(username);
+    if (it == index.end()) return LookupResult::NotFound;
+
+    MappedLog::Record r = log.at(it->second);
+    user_out.id = static_cast<int>(r.num);
+    user_out.username = std::string(r.key);
+    user_out.password = std::string(r.value);
+    return LookupResult::Found;
+}
+
+bool LogUserStore::applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) {
+    results.assign(ops.size(), false);
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const WriteOp& op = ops[i];
+        auto it = index.find(op.key);
+        if (op.type == WriteOp::Type::InsertUser && it == index.end()) {
+            results[i] = appendUser(op.key, op.value, nextId);
+        } else if (op.type == WriteOp::Type::UpdatePassword && it != index.end()) {
+            // Новая запись с тем же id заменяет старую в индексе; старая становится мусором.
+            int id = static_cast<int>(log.at(it->second).num);
+            results[i] = appendUser(op.key, op.value, id);
+        }
+    }
+
+    if (options.syncOnCommit && !log.sync()) {
+        results.assign(ops.size(), false);
+        return false;
+    }
+    maybeCompact();
+    return true;
+}
+
+void LogUserStore::maybeCompact() {
+    uint64_t total = log.size();
+    if (total < options.compactMinBytes) return;
+    if (static_cast<double>(total - liveBytes) / static_cast<double>(total) < options.compactGarbageRatio) return;
+    compactLocked();
+}
+
+bool LogUserStore::compact() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return compactLocked();
+}
+
+bool LogUserStore::compactLocked() {
+    std::vector<MappedLog::Record> live;
+    live.reserve(index.size());
+    for (const auto& entry : index)
+        live.push_back(log.at(entry.second));
+
+    // Новый индекс строится отдельно: при ошибке старый индекс и журнал не меняются.
+    uint64_t before = log.size();
+    std::unordered_map<std::string_view, uint64_t> newIndex;
+    newIndex.reserve(live.size());
+    uint64_t newLive = 0;
+
+    bool ok = log.rewrite(live, [&newIndex, &newLive](const MappedLog::Record& r, uint64_t offset) {
+        newIndex[r.key] = offset;
+        newLive += MappedLog::recordSize(r);
+    });
+    if (!ok) return false;
+
+    index.swap(newIndex);
+    liveBytes = newLive;
+
+    std::cout << "[LogUserStore] Компактирование: " << before << " -> " << log.size() << " байт" << std::endl;
+    return true;
+}
+
+// ===========================
+// REVOCATIONS
+// ===========================
+
+bool LogRevocationStore::open(const std::string& path, const LogStoreOptions& opts) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    options = opts;
+    index.clear();
+    expiries = decltype(expiries)();
+    liveBytes = 0;
+
+    uint64_t now = static_cast<uint64_t>(std::time(nullptr));
+    bool ok = log.open(path, options.reserveBytes, [this, now](const MappedLog::Record& r, uint64_t) {
+        indexRecord(r, now);
+    });
+    if (ok) {
+        std::cout << "[LogRevocationStore] Загружено отозванных токенов: " << index.size()
+                  << " (" << log.size() << " байт журнала)" << std::endl;
+    }
+    return ok;
+}
+
+void LogRevocationStore::indexRecord(const MappedLog::Record& record, uint64_t now) {
+    if (record.type != RECORD_REVOCATION || record.num < now) return;
+    if (!index.emplace(record.key, record.num).second) return;
+    expiries.emplace(record.num, record.key);
+    liveBytes += MappedLog::recordSize(record);
+}
+
+bool LogRevocationStore::appendToken(const std::string& token, uint64_t expires_at) {
+    if (index.count(token)) return true; // как INSERT OR IGNORE
+
+    MappedLog::Record record;
+    record.type = RECORD_REVOCATION;
+    record.num = expires_at;
+    record.key = token;
+
+    uint64_t offset;
+    MappedLog::Record stored;
+    if (!log.append(record, offset, stored)) return false;
+
+    index.emplace(stored.key, expires_at);
+    expiries.emplace(expires_at, stored.key);
+    liveBytes += MappedLog::recordSize(stored);
+    return true;
+}
+
+bool LogRevocationStore::blacklistToken(const std::string& token, uint64_t expires_at) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!appendToken(token, expires_at)) return false;
+    return !options.syncOnCommit || log.sync();
+}
+
+bool LogRevocationStore::isTokenBlacklisted(const std::string& token) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return index.count(token) > 0;
+}
+
+bool LogRevocationStore::findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked) {
+    revoked.assign(tokens.size(), false);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (size_t i = 0; i < tokens.size(); ++i) revoked[i] = index.count(tokens[i]) > 0;
+    return true;
+}
+
+int LogRevocationStore::purgeExpired(int batchSize, uint64_t now) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    int deleted = 0;
+    while (deleted < batchSize && !expiries.empty() && expiries.top().first < now) {
+        auto it = index.find(expiries.top().second);
+        if (it != index.end()) {
+            MappedLog::Record r;
+            r.key = it->first;
+            liveBytes -= MappedLog::recordSize(r);
+            index.erase(it);
+            deleted++;
+        }
+        expiries.pop();
+    }
+
+    uint64_t total = log.size();
+    if (deleted < batchSize && total >= options.compactMinBytes &&
+        static_cast<double>(total - liveBytes) / static_cast<double>(total) >= options.compactGarbageRatio) {
+        if (!compactLocked()) return -1;
+    }
+
+    return deleted;
+}
+
+bool LogRevocationStore::applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) {
+    results.assign(ops.size(), false);
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const WriteOp& op = ops[i];
+        if (op.type != WriteOp::Type::BlacklistToken) continue;
+        results[i] = appendToken(op.key, op.expiresAt);
+    }
+
+    if (options.syncOnCommit && !log.sync()) {
+        results.assign(ops.size(), false);
+        return false;
+    }
+    return true;
+}
+
+bool LogRevocationStore::compact() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return compactLocked();
+}
+
+bool LogRevocationStore::compactLocked() {
+    std::vector<MappedLog::Record> live;
+    live.reserve(index.size());
+    for (const auto& entry : index) {
+        MappedLog::Record r;
+        r.type = RECORD_REVOCATION;
+        r.num = entry.second;
+        r.key = entry.first;
+        live.push_back(r);
+    }
+
+    // Новые индекс и куча строятся отдельно: при ошибке старые и журнал не меняются.
+    uint64_t before = log.size();
+    std::unordered_map<std::string_view, uint64_t> newIndex;
+    newIndex.reserve(live.size());
+    decltype(expiries) newExpiries;
+    uint64_t newLive = 0;
+
+    bool ok = log.rewrite(live, [&](const MappedLog::Record& r, uint64_t) {
+        newIndex.emplace(r.key, r.num);
+        newExpiries.emplace(r.num, r.key);
+        newLive += MappedLog::recordSize(r);
+    });
+    if (!ok) return false;
+
+    index.swap(newIndex);
+    expiries = std::move(newExpiries);
+    liveBytes = newLive;
+
+    std::cout << "[LogRevocationStore] Компактирование: " << before << " -> " << log.size() << " байт" << std::endl;
+    return true;
+}
@@ -0,0 +1,303 @@
+#include "../include/MappedLog.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char LOG_MAGIC[16] = {'J', 'W', 'T', 'L', 'O', 'G', 0, 1};
+    const uint64_t HEADER_SIZE = sizeof(LOG_MAGIC);
+    const uint64_t RECORD_HEADER_SIZE = 24;
+    const uint64_t GROWTH_CHUNK = 1 << 20;
+
+    /**
+     * @brief Заголовок записи в том виде, в котором он лежит в файле.
+     */
+    struct RecordHeader {
+        uint32_t checksum;
+        uint32_t type;
+        uint32_t keyLen;
+        uint32_t valueLen;
+        uint64_t num;
+    };
+    static_assert(sizeof(RecordHeader) == RECORD_HEADER_SIZE, "unexpected record header layout");
+
+    /**
+     * @brief FNV-1a (32 бита) — достаточно, чтобы отличить оборванную запись от целой.
+     */
+    uint32_t fnv1a(const char* data, size_t len, uint32_t h = 2166136261u) {
+        for (size_t i = 0; i < len; ++i) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    uint64_t pageSize() {
+        static const uint64_t size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    uint64_t alignUp(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+
+    /**
+     * @brief Проверяет, что на месте заголовка записи (или до конца файла) одни нули.
+     */
+    bool isZeroHeader(const char* p, uint64_t available) {
+        uint64_t n = std::min(available, RECORD_HEADER_SIZE);
+        for (uint64_t i = 0; i < n; ++i) {
+            if (p[i] != 0) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Пишет буфер целиком, продолжая после коротких записей и EINTR.
+     */
+    bool writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Синхронизирует каталог файла, чтобы rename пережил сбой питания.
+     */
+    bool syncDirectory(const std::string& filePath) {
+        size_t slash = filePath.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : filePath.substr(0, slash));
+        int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dirFd < 0) return false;
+        bool ok = fsync(dirFd) == 0;
+        ::close(dirFd);
+        return ok;
+    }
+
+    /**
+     * @brief Сериализует запись в буфер dst (длиной recordSize(record)).
+     */
+    void encodeRecord(const MappedLog::Record& record, char* dst, uint64_t total) {
+        RecordHeader h;
+        h.checksum = 0;
+        h.type = record.type;
+        h.keyLen = static_cast<uint32_t>(record.key.size());
+        h.valueLen = static_cast<uint32_t>(record.value.size());
+        h.num = record.num;
+
+        std::memcpy(dst, &h, sizeof(h));
+        std::memcpy(dst + sizeof(h), record.key.data(), record.key.size());
+        std::memcpy(dst + sizeof(h) + record.key.size(), record.value.data(), record.value.size());
+        uint64_t payloadEnd = sizeof(h) + record.key.size() + record.value.size();
+        std::memset(dst + payloadEnd, 0, total - payloadEnd);
+
+        h.checksum = fnv1a(dst + sizeof(uint32_t), payloadEnd - sizeof(uint32_t));
+        std::memcpy(dst, &h.checksum, sizeof(h.checksum));
+    }
+}
+
+MappedLog::~MappedLog() {
+    close();
+}
+
+uint64_t MappedLog::recordSize(const Record& record) {
+    return alignUp(RECORD_HEADER_SIZE + record.key.size() + record.value.size(), 8);
+}
+
+bool MappedLog::mapFile(const std::string& filePath, size_t reserveBytes) {
+    fd = ::open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "[MappedLog] Не удалось открыть " << filePath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    fileSize = static_cast<uint64_t>(st.st_size);
+
+    reserved = alignUp(reserveBytes, pageSize());
+    if (fileSize > reserved) {
+        std::cerr << "[MappedLog] Журнал " << filePath << " больше зарезервированного размера" << std::endl;
+        return false;
+    }
+
+    void* addr = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[MappedLog] mmap не удался: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    base = static_cast<char*>(addr);
+    return true;
+}
+
+bool MappedLog::open(const std::string& filePath, size_t reserveBytes,
+                     const std::function<void(const Record&, uint64_t)>& onRecord) {
+    close();
+    path = filePath;
+    if (!mapFile(path, reserveBytes)) {
+        close();
+        return false;
+    }
+
+    if (fileSize < HEADER_SIZE) {
+        if (!ensureCapacity(HEADER_SIZE)) {
+            close();
+            return false;
+        }
+        std::memcpy(base, LOG_MAGIC, HEADER_SIZE);
+        used = HEADER_SIZE;
+        synced = 0;
+        return sync();
+    }
+
+    if (std::memcmp(base, LOG_MAGIC, HEADER_SIZE) != 0) {
+        std::cerr << "[MappedLog] " << path << " не является журналом" << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t offset = HEADER_SIZE;
+    while (offset + RECORD_HEADER_SIZE <= fileSize) {
+        RecordHeader h;
+        std::memcpy(&h, base + offset, sizeof(h));
+        if (h.type == 0) break;
+
+        uint64_t payload = RECORD_HEADER_SIZE + uint64_t(h.keyLen) + h.valueLen;
+        uint64_t total = alignUp(payload, 8);
+        if (offset + total > fileSize) break;
+        if (fnv1a(base + offset + sizeof(uint32_t), payload - sizeof(uint32_t)) != h.checksum) break;
+
+        onRecord(at(offset), offset);
+        offset += total;
+    }
+
+    // Обнуляем только оборванную запись — до ближайшего нулевого заголовка, чтобы её байты
+    // не приняли за записи при следующем чтении. Чистый предвыделенный хвост не трогаем.
+    uint64_t tornEnd = offset;
+    while (tornEnd < fileSize && !isZeroHeader(base + tornEnd, fileSize - tornEnd)) tornEnd += 8;
+    tornEnd = std::min(tornEnd, fileSize);
+    if (tornEnd > offset) {
+        std::memset(base + offset, 0, tornEnd - offset);
+        uint64_t from = offset / pageSize() * pageSize();
+        msync(base + from, tornEnd - from, MS_SYNC);
+    }
+
+    used = offset;
+    synced = used;
+    return true;
+}
+
+void MappedLog::close() {
+    if (base) munmap(base, reserved);
+    if (fd >= 0) ::close(fd);
+    base = nullptr;
+    fd = -1;
+    fileSize = used = synced = 0;
+}
+
+bool MappedLog::ensureCapacity(uint64_t required) {
+    if (required <= fileSize) return true;
+    if (required > reserved) {
+        std::cerr << "[MappedLog] Журнал " << path << " переполнен" << std::endl;
+        return false;
+    }
+
+    uint64_t newSize = std::max(required, std::min<uint64_t>(fileSize * 2, fileSize + 64 * GROWTH_CHUNK));
+    newSize = std::min<uint64_t>(alignUp(std::max(newSize, GROWTH_CHUNK), pageSize()), reserved);
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        std::cerr << "[MappedLog] ftruncate не удался: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    fileSize = newSize;
+    return true;
+}
+
+bool MappedLog::append(const Record& record, uint64_t& offset, Record& stored) {
+    uint64_t total = recordSize(record);
+    if (!ensureCapacity(used + total)) return false;
+
+    offset = used;
+    encodeRecord(record, base + offset, total);
+    used += total;
+    stored = at(offset);
+    return true;
+}
+
+bool MappedLog::sync() {
+    if (used <= synced) return true;
+    uint64_t from = synced / pageSize() * pageSize();
+    if (msync(base + from, used - from, MS_SYNC) != 0) {
+        std::cerr << "[MappedLog] msync не удался: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    synced = used;
+    return true;
+}
+
+MappedLog::Record MappedLog::at(uint64_t offset) const {
+    RecordHeader h;
+    std::memcpy(&h, base + offset, sizeof(h));
+
+    Record r;
+    r.type = h.type;
+    r.num = h.num;
+    r.key = std::string_view(base + offset + RECORD_HEADER_SIZE, h.keyLen);
+    r.value = std::string_view(base + offset + RECORD_HEADER_SIZE + h.keyLen, h.valueLen);
+    return r;
+}
+
+void MappedLog::swap(MappedLog& other) {
+    std::swap(path, other.path);
+    std::swap(fd, other.fd);
+    std::swap(base, other.base);
+    std::swap(reserved, other.reserved);
+    std::swap(fileSize, other.fileSize);
+    std::swap(used, other.used);
+    std::swap(synced, other.synced);
+}
+
+bool MappedLog::rewrite(const std::vector<Record>& live,
+                        const std::function<void(const Record&, uint64_t)>& onRecord) {
+    std::string tmpPath = path + ".compact";
+    int tmp = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (tmp < 0) return false;
+
+    std::string buffer(LOG_MAGIC, HEADER_SIZE);
+    for (const Record& r : live) {
+        uint64_t total = recordSize(r);
+        size_t pos = buffer.size();
+        buffer.resize(pos + total);
+        encodeRecord(r, &buffer[pos], total);
+    }
+
+    bool ok = buffer.size() <= reserved && writeAll(tmp, buffer.data(), buffer.size()) && fsync(tmp) == 0;
+    ::close(tmp);
+
+    // Новый файл отображается до rename и отдельно от текущего: при любой ошибке
+    // журнал и записи, на которые ссылаются индексы владельца, остаются прежними.
+    MappedLog fresh;
+    if (!ok || !fresh.open(tmpPath, reserved, onRecord) || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "[MappedLog] Не удалось компактировать " << path << std::endl;
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    if (!syncDirectory(path))
+        std::cerr << "[MappedLog] Не удалось синхронизировать каталог " << path << ": " << std::strerror(errno)
+                  << std::endl;
+
+    // Отображение переживает rename: это тот же файл. Старое снимается деструктором fresh.
+    fresh.path = path;
+    swap(fresh);
+    return true;
+}
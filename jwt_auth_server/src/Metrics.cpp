@@ -0,0 +1,283 @@
+#include "../include/Metrics.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace {
+    const unsigned SUB_BITS = 2;                       ///< 2^SUB_BITS интервалов на степень двойки.
+    const size_t SUB = size_t(1) << SUB_BITS;
+    const unsigned MAX_BIT = 35;                       ///< Старший учитываемый бит (2^35 нс ≈ 34 с).
+    const size_t BUCKETS = (MAX_BIT - SUB_BITS + 2) * SUB + 1;   ///< Последний интервал — переполнение (+Inf).
+
+    /// Коды ответов с отдельным счётчиком; прочие учитываются как "other".
+    const int STATUSES[] = {200, 201, 204, 304, 400, 401, 403, 404, 409, 411, 413, 429, 431, 500, 503, 505};
+    const size_t STATUS_SLOTS = sizeof(STATUSES) / sizeof(STATUSES[0]) + 1;
+
+    const char* const STAGE_NAMES[] = {"sha256", "rsa_sign", "rsa_verify", "base64_encode", "base64_decode",
+                                       "sqlite", "key_load"};
+    static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(MetricStage::Count),
+                  "имя на каждый MetricStage");
+
+    using Counter = std::atomic<uint64_t>;
+
+    /**
+     * @brief Увеличивает счётчик, в который пишет только текущий поток.
+     */
+    inline void bump(Counter& counter, uint64_t by = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    size_t bucketIndex(uint64_t nanos) {
+        if (nanos < SUB) return static_cast<size_t>(nanos);
+        unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(nanos));
+        if (msb > MAX_BIT) return BUCKETS - 1;
+        unsigned shift = msb - SUB_BITS;
+        return (shift + 1) * SUB + static_cast<size_t>((nanos >> shift) - SUB);
+    }
+
+    /**
+     * @brief Верхняя граница интервала (не включая), нс.
+     */
+    uint64_t bucketUpper(size_t index) {
+        if (index < SUB) return index + 1;
+        size_t shift = index / SUB - 1;
+        return (static_cast<uint64_t>(SUB + index % SUB) + 1) << shift;
+    }
+
+    size_t statusSlot(int status) {
+        for (size_t i = 0; i + 1 < STATUS_SLOTS; ++i)
+            if (STATUSES[i] == status) return i;
+        return STATUS_SLOTS - 1;
+    }
+
+    struct Histogram {
+        std::array<Counter, BUCKETS> buckets{};
+        Counter sumNanos{0};
+
+        void record(uint64_t nanos) {
+            bump(buckets[bucketIndex(nanos)]);
+            bump(sumNanos, nanos);
+        }
+    };
+
+    /**
+     * @brief Счётчики одного потока.
+     */
+    struct ThreadSlot {
+        std::atomic<bool> inUse{false};
+        std::array<Histogram, static_cast<size_t>(MetricStage::Count)> stages;
+        std::array<Histogram, Metrics::MAX_ROUTES> requests;
+        std::array<std::array<Counter, STATUS_SLOTS>, Metrics::MAX_ROUTES> statuses{};
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadSlot>> slots;
+        std::vector<std::string> routeLabels;
+    };
+
+    /**
+     * @brief Не разрушается: потоки, завершающиеся после main(), ещё возвращают свои блоки.
+     */
+    Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    ThreadSlot* acquireSlot() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto& slot : r.slots) {
+            bool expected = false;
+            if (slot->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) return slot.get();
+        }
+        r.slots.push_back(std::make_unique<ThreadSlot>());
+        r.slots.back()->inUse.store(true, std::memory_order_relaxed);
+        return r.slots.back().get();
+    }
+
+    /**
+     * @brief Блок потока; при завершении потока возвращается в Registry.
+     */
+    struct SlotOwner {
+        ThreadSlot* slot = nullptr;
+        ~SlotOwner() {
+            if (slot) slot->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    thread_local SlotOwner owner;
+
+    ThreadSlot& localSlot() {
+        if (!owner.slot) owner.slot = acquireSlot();
+        return *owner.slot;
+    }
+
+    /**
+     * @brief Сумма гистограмм всех потоков.
+     */
+    struct Snapshot {
+        std::array<uint64_t, BUCKETS> buckets{};
+        uint64_t sumNanos = 0;
+        uint64_t count = 0;
+
+        void add(const Histogram& h) {
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                uint64_t n = h.buckets[i].load(std::memory_order_relaxed);
+                buckets[i] += n;
+                count += n;
+            }
+            sumNanos += h.sumNanos.load(std::memory_order_relaxed);
+        }
+    };
+
+    void appendNumber(std::string& out, double value) {
+        char buf[32];
+        int len = std::snprintf(buf, sizeof(buf), "%.9g", value);
+        out.append(buf, static_cast<size_t>(len));
+    }
+
+    void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    /**
+     * @brief Интервалы от первого до последнего непустого, +Inf, _sum и _count.
+     *
+     * Пустые интервалы по краям не меняют накопленных значений, а их 140 строк
+     * на гистограмму занимали бы большую часть ответа.
+     */
+    void appendHistogram(std::string& out, const char* name, const std::string& labels, const Snapshot& s) {
+        size_t first = BUCKETS, last = 0;
+        for (size_t i = 0; i + 1 < BUCKETS; ++i) {
+            if (!s.buckets[i]) continue;
+            first = std::min(first, i);
+            last = i;
+        }
+
+        uint64_t cumulative = 0;
+        for (size_t i = first; i <= last; ++i) {
+            cumulative += s.buckets[i];
+            out += name;
+            out += "_bucket{";
+            out += labels;
+            out += ",le=\"";
+            appendNumber(out, static_cast<double>(bucketUpper(i)) / 1e9);
+            out += "\"} ";
+            out += std::to_string(cumulative);
+            out += '\n';
+        }
+        out += name;
+        out += "_bucket{";
+        out += labels;
+        out += ",le=\"+Inf\"} ";
+        out += std::to_string(s.count);
+        out += '\n';
+
+        out += name;
+        out += "_sum{";
+        out += labels;
+        out += "} ";
+        appendNumber(out, static_cast<double>(s.sumNanos) / 1e9);
+        out += '\n';
+
+        out += name;
+        out += "_count{";
+        out += labels;
+        out += "} ";
+        out += std::to_string(s.count);
+        out += '\n';
+    }
+}
+
+void Metrics::setRoutes(const std::vector<std::string>& labels) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.routeLabels = labels;
+    r.routeLabels.resize(std::min(r.routeLabels.size(), MAX_ROUTES));
+}
+
+void Metrics::recordRequest(size_t route, int status, uint64_t nanos) {
+    ThreadSlot& slot = localSlot();
+    route = std::min(route, MAX_ROUTES - 1);
+    bump(slot.statuses[route][statusSlot(status)]);
+    if (nanos != UNTIMED) slot.requests[route].record(nanos);
+}
+
+void Metrics::recordStage(MetricStage stage, uint64_t nanos) {
+    localSlot().stages[static_cast<size_t>(stage)].record(nanos);
+}
+
+void Metrics::appendValue(std::string& out, const char* name, const char* type, const char* help, uint64_t value) {
+    appendHeader(out, name, type, help);
+    out += name;
+    out += ' ';
+    out += std::to_string(value);
+    out += '\n';
+}
+
+void Metrics::render(std::string& out) {
+    std::array<Snapshot, static_cast<size_t>(MetricStage::Count)> stages;
+    std::array<Snapshot, MAX_ROUTES> requests;
+    std::array<std::array<uint64_t, STATUS_SLOTS>, MAX_ROUTES> statuses{};
+    std::vector<std::string> labels;
+    size_t threads = 0;
+
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        labels = r.routeLabels;
+        threads = r.slots.size();
+        for (const auto& slot : r.slots) {
+            for (size_t i = 0; i < stages.size(); ++i) stages[i].add(slot->stages[i]);
+            for (size_t route = 0; route < MAX_ROUTES; ++route) {
+                requests[route].add(slot->requests[route]);
+                for (size_t i = 0; i < STATUS_SLOTS; ++i)
+                    statuses[route][i] += slot->statuses[route][i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    appendHeader(out, "jwt_http_requests_total", "counter", "Requests by route and response status.");
+    for (size_t route = 0; route < labels.size(); ++route) {
+        for (size_t i = 0; i < STATUS_SLOTS; ++i) {
+            if (!statuses[route][i]) continue;
+            out += "jwt_http_requests_total{";
+            out += labels[route];
+            out += ",status=\"";
+            out += (i + 1 < STATUS_SLOTS) ? std::to_string(STATUSES[i]) : "other";
+            out += "\"} ";
+            out += std::to_string(statuses[route][i]);
+            out += '\n';
+        }
+    }
+
+    appendHeader(out, "jwt_http_request_duration_seconds", "histogram",
+                 "Time from a parsed request to a ready response, by route.");
+    for (size_t route = 0; route < labels.size(); ++route) {
+        if (requests[route].count)
+            appendHistogram(out, "jwt_http_request_duration_seconds", labels[route], requests[route]);
+    }
+
+    appendHeader(out, "jwt_stage_duration_seconds", "histogram",
+                 "Time spent in SHA-256, RSA, Base64, SQLite and key loading.");
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (stages[i].count)
+            appendHistogram(out, "jwt_stage_duration_seconds", std::string("stage=\"") + STAGE_NAMES[i] + "\"",
+                            stages[i]);
+    }
+
+    appendValue(out, "jwt_metrics_thread_slots", "gauge", "Per-thread counter blocks allocated.", threads);
+}
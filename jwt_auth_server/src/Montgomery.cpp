@@ -0,0 +1,179 @@
+#include "../include/Montgomery.h"
+
+#include <cstring>
+
+namespace {
+    /**
+     * @brief Читает big-endian байты в слова (младшие первыми).
+     * @return false, если значимая часть не помещается в limbs слов.
+     */
+    bool bytesToLimbs(const uint8_t* in, size_t len, uint32_t* limbs, size_t count) {
+        std::memset(limbs, 0, count * sizeof(uint32_t));
+        for (size_t i = 0; i < len; ++i) {
+            size_t pos = len - 1 - i;   // номер байта от младшего
+            if (pos / 4 >= count) {
+                if (in[i] != 0) return false;
+                continue;
+            }
+            limbs[pos / 4] |= static_cast<uint32_t>(in[i]) << (8 * (pos % 4));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Записывает слова в big-endian буфер.
+     * @return false, если значимая часть не помещается в len байт.
+     */
+    bool limbsToBytes(const uint32_t* limbs, size_t count, uint8_t* out, size_t len) {
+        std::memset(out, 0, len);
+        for (size_t pos = 0; pos < count * 4; ++pos) {
+            uint8_t b = static_cast<uint8_t>(limbs[pos / 4] >> (8 * (pos % 4)));
+            if (pos >= len) {
+                if (b != 0) return false;
+                continue;
+            }
+            out[len - 1 - pos] = b;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Сравнение a < b для чисел из count слов.
+     */
+    bool lessThan(const uint32_t* a, const uint32_t* b, size_t count) {
+        for (size_t i = count; i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i];
+        }
+        return false;
+    }
+
+    /**
+     * @brief a -= b, возвращает заём.
+     */
+    uint32_t subtract(uint32_t* a, const uint32_t* b, size_t count) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t d = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+            a[i] = static_cast<uint32_t>(d);
+            borrow = (d >> 63) & 1;
+        }
+        return static_cast<uint32_t>(borrow);
+    }
+}
+
+std::shared_ptr<const MontgomeryContext> MontgomeryContext::create(const BigInt& modulus) {
+    if (modulus.isNegative() || modulus <= BigInt(1)) return nullptr;
+
+    // Каждая десятичная цифра — меньше 4 бит, поэтому буфера такой длины всегда хватает.
+    size_t upperBound = (modulus.toString().size() * 4 + 7) / 8;
+    std::vector<uint8_t> raw(upperBound);
+    if (!modulus.toBytes(raw.data(), raw.size())) return nullptr;
+
+    size_t skip = 0;
+    while (skip < raw.size() && raw[skip] == 0) ++skip;
+    size_t byteLen = raw.size() - skip;
+    size_t limbs = (byteLen + 3) / 4;
+    if (limbs == 0 || limbs > MAX_LIMBS) return nullptr;
+
+    auto ctx = std::make_shared<MontgomeryContext>();
+    ctx->bytes = byteLen;
+    ctx->n.assign(limbs, 0);
+    bytesToLimbs(raw.data() + skip, byteLen, ctx->n.data(), limbs);
+    if ((ctx->n[0] & 1) == 0) return nullptr;
+
+    // Обратный к n[0] по модулю 2^32 методом Ньютона: каждая итерация удваивает число верных бит.
+    uint32_t inv = 1;
+    for (int i = 0; i < 5; ++i) inv *= 2 - ctx->n[0] * inv;
+    ctx->n0inv = 0u - inv;
+
+    // R^2 mod n: единица, удвоенная 2 * 32 * limbs раз с вычитанием n.
+    ctx->rr.assign(limbs, 0);
+    ctx->rr[0] = 1;
+    for (size_t i = 0; i < 64 * limbs; ++i) {
+        uint32_t carry = 0;
+        for (size_t j = 0; j < limbs; ++j) {
+            uint32_t next = ctx->rr[j] >> 31;
+            ctx->rr[j] = (ctx->rr[j] << 1) | carry;
+            carry = next;
+        }
+        if (carry || !lessThan(ctx->rr.data(), ctx->n.data(), limbs))
+            subtract(ctx->rr.data(), ctx->n.data(), limbs);
+    }
+
+    return ctx;
+}
+
+size_t MontgomeryContext::byteLength() const {
+    return bytes;
+}
+
+void MontgomeryContext::mul(const uint32_t* a, const uint32_t* b, uint32_t* out) const {
+    const size_t k = n.size();
+    uint32_t t[MAX_LIMBS + 2] = {};
+
+    for (size_t i = 0; i < k; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < k; ++j) {
+            uint64_t s = t[j] + static_cast<uint64_t>(a[j]) * b[i] + carry;
+            t[j] = static_cast<uint32_t>(s);
+            carry = s >> 32;
+        }
+        uint64_t s = t[k] + carry;
+        t[k] = static_cast<uint32_t>(s);
+        t[k + 1] = static_cast<uint32_t>(s >> 32);
+
+        // Прибавляем m * n так, чтобы младшее слово обнулилось, и сдвигаем на слово.
+        uint32_t m = t[0] * n0inv;
+        s = t[0] + static_cast<uint64_t>(m) * n[0];
+        carry = s >> 32;
+        for (size_t j = 1; j < k; ++j) {
+            s = t[j] + static_cast<uint64_t>(m) * n[j] + carry;
+            t[j - 1] = static_cast<uint32_t>(s);
+            carry = s >> 32;
+        }
+        s = t[k] + carry;
+        t[k - 1] = static_cast<uint32_t>(s);
+        t[k] = t[k + 1] + static_cast<uint32_t>(s >> 32);
+    }
+
+    // Результат меньше 2n — достаточно одного условного вычитания.
+    if (t[k] != 0 || !lessThan(t, n.data(), k))
+        subtract(t, n.data(), k);
+    std::memcpy(out, t, k * sizeof(uint32_t));
+}
+
+bool MontgomeryContext::modPow(const uint8_t* base, size_t baseLen, uint32_t exponent,
+                               uint8_t* out, size_t outLen) const {
+    const size_t k = n.size();
+    if (exponent == 0) return false;
+
+    uint32_t x[MAX_LIMBS];
+    if (!bytesToLimbs(base, baseLen, x, k) || !lessThan(x, n.data(), k)) return false;
+
+    uint32_t acc[MAX_LIMBS];
+    mul(x, rr.data(), acc);   // acc = x * R mod n
+
+    if (exponent == 65537) {
+        // x^65536 * R, затем умножение на x без R — выход из формы Монтгомери бесплатно.
+        for (int i = 0; i < 16; ++i) mul(acc, acc, acc);
+        mul(acc, x, acc);
+    } else if (exponent == 3) {
+        mul(acc, acc, acc);
+        mul(acc, x, acc);
+    } else {
+        uint32_t xm[MAX_LIMBS];
+        std::memcpy(xm, acc, k * sizeof(uint32_t));
+
+        int top = 31;
+        while (!((exponent >> top) & 1)) --top;
+        for (int bit = top - 1; bit >= 0; --bit) {
+            mul(acc, acc, acc);
+            if ((exponent >> bit) & 1) mul(acc, xm, acc);
+        }
+
+        uint32_t one[MAX_LIMBS] = {1};
+        mul(acc, one, acc);
+    }
+
+    return limbsToBytes(acc, k, out, outLen);
+}
@@ -1,7 +1,212 @@
 #include "../include/PasswordEncryptor.h"
 #include "../include/SHA256.h"
+#include "../include/KDF.h"
+#include "../include/ConstantTime.h"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace {
+    std::mutex params_mutex;
+    PasswordHashParams current_params;
+
+    const char* PBKDF2_ID = "pbkdf2-sha256";
+    const char* BALLOON_ID = "balloon-sha256";
+
+    std::string toHex(const std::string& bytes) {
+        static const char* hex = "0123456789abcdef";
+        std::string out(bytes.size() * 2, '0');
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(bytes[i]);
+            out[i * 2] = hex[c >> 4];
+            out[i * 2 + 1] = hex[c & 0x0F];
+        }
+        return out;
+    }
+
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+        return -1;
+    }
+
+    bool fromHex(const std::string& hex, std::string& out) {
+        if (hex.size() % 2 != 0) return false;
+        out.resize(hex.size() / 2);
+        for (size_t i = 0; i < out.size(); ++i) {
+            int hi = hexValue(hex[i * 2]), lo = hexValue(hex[i * 2 + 1]);
+            if (hi < 0 || lo < 0) return false;
+            out[i] = static_cast<char>((hi << 4) | lo);
+        }
+        return true;
+    }
+
+    std::string randomSalt(size_t bytes) {
+        static thread_local std::random_device rd;
+        std::string salt(bytes, '\0');
+        for (size_t i = 0; i < bytes; i += 4) {
+            uint32_t v = rd();
+            for (size_t j = 0; j < 4 && i + j < bytes; ++j)
+                salt[i + j] = static_cast<char>(v >> (j * 8));
+        }
+        return salt;
+    }
+
+    std::vector<std::string> split(const std::string& s, char delim) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (true) {
+            size_t pos = s.find(delim, start);
+            parts.push_back(s.substr(start, pos - start));
+            if (pos == std::string::npos) break;
+            start = pos + 1;
+        }
+        return parts;
+    }
+
+    bool parseUint(const std::string& s, uint32_t& out) {
+        if (s.empty() || s.size() > 10) return false;
+        uint64_t v = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return false;
+            v = v * 10 + static_cast<uint64_t>(c - '0');
+        }
+        if (v == 0 || v > 0xFFFFFFFFull) return false;
+        out = static_cast<uint32_t>(v);
+        return true;
+    }
+
+    SHA256::Digest derive(const std::string& password, const std::string& salt, const PasswordHashParams& p) {
+        if (p.algorithm == PasswordAlgorithm::Balloon)
+            return KDF::balloonSha256(password, salt, p.memoryBlocks, p.rounds);
+        return KDF::pbkdf2Sha256(password, salt, p.iterations);
+    }
+
+    /**
+     * @brief Разбирает строку `$<алгоритм>$<параметры>$<соль>$<хеш>`.
+     */
+    bool parseEncoded(const std::string& encoded, PasswordHashParams& params, std::string& salt, SHA256::Digest& hash) {
+        std::vector<std::string> parts = split(encoded, '$');
+        if (parts.size() != 5 || !parts[0].empty()) return false;
+
+        if (parts[1] == PBKDF2_ID) {
+            params.algorithm = PasswordAlgorithm::PBKDF2;
+            if (parts[2].rfind("i=", 0) != 0 || !parseUint(parts[2].substr(2), params.iterations)) return false;
+        } else if (parts[1] == BALLOON_ID) {
+            params.algorithm = PasswordAlgorithm::Balloon;
+            std::vector<std::string> costs = split(parts[2], ',');
+            if (costs.size() != 2 || costs[0].rfind("s=", 0) != 0 || costs[1].rfind("t=", 0) != 0) return false;
+            if (!parseUint(costs[0].substr(2), params.memoryBlocks) ||
+                !parseUint(costs[1].substr(2), params.rounds)) return false;
+        } else {
+            return false;
+        }
+
+        return fromHex(parts[3], salt) && SHA256::fromHex(parts[4], hash);
+    }
+
+    double measureMillis(const PasswordHashParams& p) {
+        std::string salt = randomSalt(p.saltBytes);
+        double best = 1e18;
+        for (int i = 0; i < 3; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            derive("calibration-password", salt, p);
+            best = std::min(best, std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+        return std::max(best, 0.001);
+    }
+}
+
+void PasswordEncryptor::configure(const PasswordHashParams& params) {
+    std::lock_guard<std::mutex> lock(params_mutex);
+    current_params = params;
+}
+
+PasswordHashParams PasswordEncryptor::currentParams() {
+    std::lock_guard<std::mutex> lock(params_mutex);
+    return current_params;
+}
 
 std::string PasswordEncryptor::hashPassword(const std::string& password) {
-    return SHA256::hash(password);
+    return hashPassword(password, currentParams());
 }
 
+std::string PasswordEncryptor::hashPassword(const std::string& password, const PasswordHashParams& params) {
+    if (params.algorithm == PasswordAlgorithm::LegacySHA256)
+        return SHA256::toHex(SHA256::digest(password.data(), password.size()));
+
+    std::string salt = randomSalt(params.saltBytes);
+    SHA256::Digest dk = derive(password, salt, params);
+
+    std::string encoded = "$";
+    if (params.algorithm == PasswordAlgorithm::Balloon) {
+        encoded += BALLOON_ID;
+        encoded += "$s=" + std::to_string(params.memoryBlocks) + ",t=" + std::to_string(params.rounds);
+    } else {
+        encoded += PBKDF2_ID;
+        encoded += "$i=" + std::to_string(params.iterations);
+    }
+    encoded += "$" + toHex(salt) + "$" + SHA256::toHex(dk);
+    return encoded;
+}
+
+bool PasswordEncryptor::verifyPassword(const std::string& password, const std::string& encoded) {
+    if (encoded.empty() || encoded[0] != '$') {
+        // Старый формат: несолёный SHA-256 в hex.
+        SHA256::Digest expected;
+        if (!SHA256::fromHex(encoded, expected)) return false;
+        return ConstantTime::equal(SHA256::digest(password.data(), password.size()), expected);
+    }
+
+    PasswordHashParams params;
+    std::string salt;
+    SHA256::Digest expected;
+    if (!parseEncoded(encoded, params, salt, expected)) return false;
+
+    return ConstantTime::equal(derive(password, salt, params), expected);
+}
+
+bool PasswordEncryptor::needsRehash(const std::string& encoded) {
+    PasswordHashParams current = currentParams();
+    if (current.algorithm == PasswordAlgorithm::LegacySHA256) return false;
+
+    PasswordHashParams stored;
+    std::string salt;
+    SHA256::Digest hash;
+    if (encoded.empty() || encoded[0] != '$' || !parseEncoded(encoded, stored, salt, hash)) return true;
+    if (stored.algorithm != current.algorithm) return true;
+
+    if (stored.algorithm == PasswordAlgorithm::Balloon)
+        return stored.memoryBlocks < current.memoryBlocks || stored.rounds < current.rounds;
+    return stored.iterations < current.iterations;
+}
+
+PasswordHashParams PasswordEncryptor::calibrate(PasswordAlgorithm algorithm, std::chrono::milliseconds target) {
+    PasswordHashParams params = currentParams();
+    params.algorithm = algorithm;
+    double targetMs = static_cast<double>(target.count());
+
+    if (algorithm == PasswordAlgorithm::Balloon) {
+        params.memoryBlocks = 1024;
+        double ms = measureMillis(params);
+        double scaled = params.memoryBlocks * targetMs / ms;
+        params.memoryBlocks = static_cast<uint32_t>(std::clamp(scaled, 1024.0, double(1u << 22)));
+        std::cout << "[PasswordEncryptor] Калибровка Balloon: " << params.memoryBlocks << " блоков ("
+                  << params.memoryBlocks * SHA256::DIGEST_SIZE / 1024 << " КиБ), " << params.rounds
+                  << " раунда, ~" << measureMillis(params) << " мс на хеш" << std::endl;
+    } else if (algorithm == PasswordAlgorithm::PBKDF2) {
+        params.iterations = 2000;
+        double ms = measureMillis(params);
+        double scaled = params.iterations * targetMs / ms;
+        params.iterations = static_cast<uint32_t>(std::clamp(scaled, 1000.0, 10000000.0));
+        std::cout << "[PasswordEncryptor] Калибровка PBKDF2: " << params.iterations
+                  << " итераций, ~" << measureMillis(params) << " мс на хеш" << std::endl;
+    }
+
+    return params;
+}
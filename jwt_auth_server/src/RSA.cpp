@@ -1,7 +1,12 @@
 #include "../include/RSA.h"
+#include "../include/ConstantTime.h"
+#include "../include/Montgomery.h"
+#include "../include/Metrics.h"
 #include <random>
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <mutex>
 
 static bool is_prime(const BigInt& n, int iterations = 10) {
     if (n <= BigInt(1)) return false;
@@ -126,6 +131,7 @@ BigInt RSA::decrypt(const BigInt& cipher, const RSAPrivateKey& key) {
 }
 
 BigInt RSA::sign(const BigInt& hash, const RSAPrivateKey& key) {
+    StageTimer timer(MetricStage::RsaSign);
     std::cout << "[RSA] --- Подпись ---" << std::endl;
     std::cout << "Hash (hex): " << hash.toString(16) << std::endl;
     BigInt sig = BigInt::modPow(hash, key.d, key.n);
@@ -134,20 +140,112 @@ BigInt RSA::sign(const BigInt& hash, const RSAPrivateKey& key) {
 }
 
 bool RSA::verify(const std::string& messageHashHex, const BigInt& signature, const RSAPublicKey& key) {
-    std::cout << "[RSA] --- Верификация подписи ---" << std::endl;
-    std::cout << "Expected hash:  " << messageHashHex << std::endl;
-    std::cout << "Signature:      " << signature.toString(16) << std::endl;
+    SHA256::Digest messageHash;
+    if (!SHA256::fromHex(messageHashHex, messageHash)) return false;
+    return verify(messageHash, signature, key);
+}
+
+namespace {
+    /**
+     * @brief Открытый ключ, подготовленный к быстрой проверке подписей.
+     */
+    struct VerifyKey {
+        BigInt e;
+        BigInt n;
+        uint32_t smallExponent = 0;                            ///< e, если помещается в 32 бита; иначе 0.
+        std::shared_ptr<const MontgomeryContext> montgomery;   ///< nullptr — только BigInt::modPow.
+
+        bool fast() const { return smallExponent != 0 && montgomery; }
+    };
+
+    std::mutex verify_key_mutex;                  ///< Только для пересборки verify_key.
+    std::shared_ptr<const VerifyKey> verify_key;  ///< Читается и публикуется через std::atomic_load/atomic_store.
+
+    bool preparedFor(const std::shared_ptr<const VerifyKey>& prepared, const RSAPublicKey& key) {
+        return prepared && prepared->n == key.n && prepared->e == key.e;
+    }
+
+    /**
+     * @brief Возвращает подготовленный ключ; пересобирает его только при смене ключа.
+     *
+     * Проверяющие потоки читают ключ без блокировки, мьютекс берётся только для пересборки.
+     */
+    std::shared_ptr<const VerifyKey> verifyKeyFor(const RSAPublicKey& key) {
+        std::shared_ptr<const VerifyKey> current = std::atomic_load(&verify_key);
+        if (preparedFor(current, key)) return current;
+
+        std::lock_guard<std::mutex> lock(verify_key_mutex);
+        current = std::atomic_load(&verify_key);
+        if (preparedFor(current, key)) return current;
+
+        auto prepared = std::make_shared<VerifyKey>();
+        prepared->e = key.e;
+        prepared->n = key.n;
+
+        uint8_t e[4];
+        if (!key.e.isNegative() && key.e.toBytes(e, sizeof(e))) {
+            prepared->smallExponent = (static_cast<uint32_t>(e[0]) << 24) | (static_cast<uint32_t>(e[1]) << 16) |
+                                      (static_cast<uint32_t>(e[2]) << 8) | e[3];
+        }
+        prepared->montgomery = MontgomeryContext::create(key.n);
+
+        if (prepared->fast()) {
+            std::cout << "[RSA] Контекст Монтгомери подготовлен: e = " << prepared->smallExponent
+                      << ", модуль " << prepared->montgomery->byteLength() * 8 << " бит" << std::endl;
+        } else {
+            std::cout << "[RSA] Ключ не подходит для быстрой проверки, используется BigInt::modPow" << std::endl;
+        }
 
-    BigInt decryptedHashInt = BigInt::modPow(signature, key.e, key.n);
-    std::string decryptedHashHex = decryptedHashInt.toString(16);
+        std::shared_ptr<const VerifyKey> published = prepared;
+        std::atomic_store(&verify_key, published);
+        return published;
+    }
+
+    std::string bytesToHex(const uint8_t* data, size_t len) {
+        static const char* hex = "0123456789abcdef";
+        std::string out;
+        out.reserve(len * 2);
+        for (size_t i = 0; i < len; ++i) {
+            out += hex[data[i] >> 4];
+            out += hex[data[i] & 0x0F];
+        }
+        return out;
+    }
+
+    bool verifyWithModPow(const SHA256::Digest& messageHash, const BigInt& signature, const RSAPublicKey& key) {
+        BigInt decryptedHashInt = BigInt::modPow(signature, key.e, key.n);
 
-    while (decryptedHashHex.length() < 64)
-        decryptedHashHex = "0" + decryptedHashHex;
+        SHA256::Digest decryptedHash;
+        return decryptedHashInt.toBytes(decryptedHash.data(), decryptedHash.size()) &&
+               ConstantTime::equal(decryptedHash, messageHash);
+    }
 
-    std::cout << "Decrypted hash: " << decryptedHashHex << std::endl;
+    bool verifyWithMontgomery(const SHA256::Digest& messageHash, const uint8_t* signature, size_t signatureLen,
+                              const VerifyKey& key) {
+        SHA256::Digest decryptedHash;
+        return key.montgomery->modPow(signature, signatureLen, key.smallExponent,
+                                      decryptedHash.data(), decryptedHash.size()) &&
+               ConstantTime::equal(decryptedHash, messageHash);
+    }
+}
 
-    bool valid = (decryptedHashHex == messageHashHex);
-    std::cout << "Signature valid: " << (valid ? "YES" : "NO") << std::endl;
+bool RSA::verify(const SHA256::Digest& messageHash, const BigInt& signature, const RSAPublicKey& key) {
+    StageTimer timer(MetricStage::RsaVerify);
+    auto prepared = verifyKeyFor(key);
+    if (prepared->fast()) {
+        uint8_t bytes[MontgomeryContext::MAX_LIMBS * 4];
+        size_t len = prepared->montgomery->byteLength();
+        return signature.toBytes(bytes, len) && verifyWithMontgomery(messageHash, bytes, len, *prepared);
+    }
+    return verifyWithModPow(messageHash, signature, key);
+}
 
-    return valid;
+bool RSA::verify(const SHA256::Digest& messageHash, const uint8_t* signature, size_t signatureLen,
+                 const RSAPublicKey& key) {
+    // Без журнала на каждый вызов: исход проверки виден в Metrics и в отказах AuthMiddleware.
+    StageTimer timer(MetricStage::RsaVerify);
+    auto prepared = verifyKeyFor(key);
+    return prepared->fast()
+        ? verifyWithMontgomery(messageHash, signature, signatureLen, *prepared)
+        : verifyWithModPow(messageHash, BigInt(bytesToHex(signature, signatureLen), 16), key);
 }
@@ -0,0 +1,233 @@
+#include "../include/RateLimiter.h"
+#include "../include/Json.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    const uint64_t MICROS = 1000000;
+    const uint64_t SWEEP_INTERVAL_US = 10 * MICROS;   ///< Как часто шард вычищает полные корзины.
+    const uint32_t MAX_RETRY_AFTER = 300;             ///< Больший Retry-After округляется вниз до этого.
+
+    /**
+     * @brief Ограничение в микросекундах.
+     */
+    struct Rule {
+        uint64_t interval = 0;   ///< Период одного токена (0 — ограничение выключено).
+        uint64_t window = 0;     ///< Период всей корзины.
+    };
+
+    /**
+     * @brief Ограничения одного маршрута; индекс — RateLimitScope.
+     */
+    struct ScopeRules {
+        Rule perClient;
+        Rule perUser;
+    };
+
+    /**
+     * @brief Шард: корзины по ключу, значение — момент, когда корзина снова полна (мкс steady_clock).
+     */
+    struct Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::atomic<uint64_t>> buckets;
+        std::atomic<uint64_t> nextSweep{0};
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t max_per_shard = 0;
+    ScopeRules rules[3];
+
+    /// Ответ 429 для Retry-After = индекс (0 не используется).
+    std::vector<StaticResponse> too_many;
+
+    std::atomic<uint64_t> stat_limited{0};
+    std::atomic<uint64_t> stat_untracked{0};
+    std::atomic<uint64_t> stat_evicted{0};
+
+    uint64_t nowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    Rule toRule(const RateLimit& limit) {
+        Rule rule;
+        if (limit.requests == 0 || limit.periodSec == 0) return rule;
+        rule.window = limit.periodSec * MICROS;
+        rule.interval = std::max<uint64_t>(rule.window / limit.requests, 1);
+        return rule;
+    }
+
+    /**
+     * @brief Забирает токен из корзины.
+     *
+     * Корзина полна, если fullAt <= now; токен сдвигает fullAt на interval.
+     * Запрос допускается, пока fullAt не уходит дальше now + window.
+     *
+     * @param[out] retryAfter Через сколько мкс появится токен (при отказе).
+     */
+    bool take(std::atomic<uint64_t>& fullAt, const Rule& rule, uint64_t now, uint64_t& retryAfter) {
+        uint64_t current = fullAt.load(std::memory_order_relaxed);
+        for (;;) {
+            uint64_t next = std::max(current, now) + rule.interval;
+            if (next - now > rule.window) {
+                retryAfter = next - now - rule.window;
+                return false;
+            }
+            if (fullAt.compare_exchange_weak(current, next, std::memory_order_relaxed)) return true;
+        }
+    }
+
+    /**
+     * @brief Удаляет полные корзины; вызывается под исключительной блокировкой шарда.
+     */
+    void sweep(Shard& shard, uint64_t now) {
+        size_t removed = 0;
+        for (auto it = shard.buckets.begin(); it != shard.buckets.end();) {
+            if (it->second.load(std::memory_order_relaxed) <= now) {
+                it = shard.buckets.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+        shard.nextSweep.store(now + SWEEP_INTERVAL_US, std::memory_order_relaxed);
+        stat_evicted += removed;
+    }
+
+    /**
+     * @brief Проверяет корзину ключа, при необходимости создавая её.
+     */
+    bool admitKey(const std::string& key, const Rule& rule, uint64_t now, uint64_t& retryAfter) {
+        Shard& shard = *shards[std::hash<std::string>()(key) % shards.size()];
+
+        uint64_t due = shard.nextSweep.load(std::memory_order_relaxed);
+        if (now >= due && shard.nextSweep.compare_exchange_strong(due, now + SWEEP_INTERVAL_US)) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            sweep(shard, now);
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.buckets.find(key);
+            if (it != shard.buckets.end()) return take(it->second, rule, now, retryAfter);
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.find(key);
+        if (it == shard.buckets.end()) {
+            if (shard.buckets.size() >= max_per_shard) sweep(shard, now);
+            if (shard.buckets.size() >= max_per_shard) {
+                stat_untracked++;
+                return true;
+            }
+            it = shard.buckets.try_emplace(key, 0).first;
+        }
+        return take(it->second, rule, now, retryAfter);
+    }
+
+    /**
+     * @brief Достаёт username из тела /login и /register.
+     */
+    class UsernameHandler : public JsonHandler {
+    public:
+        bool onField(const JsonField& field) override {
+            if (field.key == "username") return username.assign(field);
+            return true;
+        }
+
+        JsonString<256> username;
+    };
+
+    const StaticResponse* limited(const httplib::Request& req, const char* kind, std::string_view key,
+                                  uint64_t retryAfter) {
+        uint64_t seconds = std::clamp<uint64_t>((retryAfter + MICROS - 1) / MICROS, 1, too_many.size() - 1);
+        std::cerr << "[RateLimit] " << req.path << ": превышен лимит для " << kind << " " << key
+                  << ", повтор через " << seconds << " с" << std::endl;
+        stat_limited++;
+        return &too_many[seconds];
+    }
+
+    StaticResponse prepareTooMany(uint32_t retryAfter) {
+        return StaticResponses::make(429, "Too many requests", "text/plain",
+                                     {{"Retry-After", std::to_string(retryAfter)}});
+    }
+}
+
+void RateLimiter::configure(const RateLimitSettings& settings, size_t shardCount, size_t maxBuckets) {
+    if (shardCount == 0) shardCount = 1;
+
+    shards.clear();
+    for (size_t i = 0; i < shardCount; ++i)
+        shards.push_back(std::make_unique<Shard>());
+    max_per_shard = std::max<size_t>((maxBuckets + shardCount - 1) / shardCount, 1);
+
+    rules[static_cast<size_t>(RateLimitScope::Login)].perClient = toRule(settings.loginPerClient);
+    rules[static_cast<size_t>(RateLimitScope::Login)].perUser = toRule(settings.loginPerUser);
+    rules[static_cast<size_t>(RateLimitScope::Register)].perClient = toRule(settings.registerPerClient);
+    rules[static_cast<size_t>(RateLimitScope::Register)].perUser = toRule(settings.registerPerUser);
+
+    // Retry-After не превышает период одного токена: ответы на все значения готовятся заранее.
+    uint64_t longest = 1;
+    for (const ScopeRules& scope : rules)
+        longest = std::max({longest, scope.perClient.interval, scope.perUser.interval});
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>((longest + MICROS - 1) / MICROS, MAX_RETRY_AFTER));
+
+    too_many.clear();
+    too_many.reserve(count + 1);
+    too_many.emplace_back();
+    for (uint32_t seconds = 1; seconds <= count; ++seconds) too_many.push_back(prepareTooMany(seconds));
+
+    std::cout << "[RateLimit] Шардов " << shardCount << ", корзин до " << max_per_shard * shardCount
+              << ", ответов 429: " << count << std::endl;
+}
+
+const StaticResponse* RateLimiter::admit(RateLimitScope scope, const httplib::Request& req) {
+    if (scope == RateLimitScope::None || shards.empty()) return nullptr;
+    const ScopeRules& rule = rules[static_cast<size_t>(scope)];
+    uint64_t now = nowMicros();
+    uint64_t retryAfter = 0;
+
+    // Префикс отделяет маршруты и вид ключа: IP и username не пересекаются.
+    std::string key;
+    if (rule.perClient.interval) {
+        key.reserve(2 + req.remote_addr.size());
+        key += static_cast<char>('0' + static_cast<int>(scope));
+        key += 'i';
+        key += req.remote_addr;
+        if (!admitKey(key, rule.perClient, now, retryAfter))
+            return limited(req, "IP", req.remote_addr, retryAfter);
+    }
+
+    if (rule.perUser.interval) {
+        UsernameHandler handler;
+        if (!Json::parseObject(req.body, handler) || handler.username.size == 0) return nullptr;
+        key.clear();
+        key += static_cast<char>('0' + static_cast<int>(scope));
+        key += 'u';
+        key += handler.username.view();
+        if (!admitKey(key, rule.perUser, now, retryAfter))
+            return limited(req, "пользователя", handler.username.view(), retryAfter);
+    }
+    return nullptr;
+}
+
+RateLimiterStats RateLimiter::getStats() {
+    RateLimiterStats stats;
+    stats.limited = stat_limited.load();
+    stats.untracked = stat_untracked.load();
+    stats.evicted = stat_evicted.load();
+    for (auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        stats.buckets += shard->buckets.size();
+    }
+    return stats;
+}
@@ -1,4 +1,5 @@
 #include "../include/SHA256.h"
+#include "../include/Metrics.h"
 #include <vector>
 #include <array>
 #include <sstream>
@@ -6,6 +7,7 @@
 #include <cstring>
 #include <cstdint>
 #include <iostream>
+#include <algorithm>
 
 namespace {
     /**
@@ -115,6 +117,128 @@ namespace {
     uint32_t to_uint32(const uint8_t* bytes) {
         return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
     }
+
+    /**
+     * @brief Обрабатывает один 64-байтный блок (функция сжатия SHA-256) без логирования.
+     */
+    void compress(std::array<uint32_t, 8>& h, const uint8_t* block) {
+        uint32_t w[64];
+
+        for (int j = 0; j < 16; ++j)
+            w[j] = to_uint32(block + j * 4);
+
+        for (int j = 16; j < 64; ++j)
+            w[j] = small_sigma1(w[j - 2]) + w[j - 7] +
+                   small_sigma0(w[j - 15]) + w[j - 16];
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+        uint32_t e = h[4], f = h[5], g = h[6], h_val = h[7];
+
+        for (int j = 0; j < 64; ++j) {
+            uint32_t temp1 = h_val + big_sigma1(e) + ch(e, f, g) + k[j] + w[j];
+            uint32_t temp2 = big_sigma0(a) + maj(a, b, c);
+
+            h_val = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += h_val;
+    }
+}
+
+SHA256::Context::Context()
+    : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {}
+
+void SHA256::Context::update(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    totalLen += len;
+
+    if (bufferLen > 0) {
+        size_t take = std::min(len, sizeof(buffer) - bufferLen);
+        std::memcpy(buffer + bufferLen, p, take);
+        bufferLen += take;
+        p += take;
+        len -= take;
+        if (bufferLen < sizeof(buffer)) return;
+        compress(state, buffer);
+        bufferLen = 0;
+    }
+
+    while (len >= 64) {
+        compress(state, p);
+        p += 64;
+        len -= 64;
+    }
+
+    std::memcpy(buffer, p, len);
+    bufferLen = len;
+}
+
+SHA256::Digest SHA256::Context::finish() {
+    uint64_t bitLength = totalLen * 8;
+
+    buffer[bufferLen++] = 0x80;
+    if (bufferLen > 56) {
+        std::memset(buffer + bufferLen, 0, sizeof(buffer) - bufferLen);
+        compress(state, buffer);
+        bufferLen = 0;
+    }
+    std::memset(buffer + bufferLen, 0, 56 - bufferLen);
+    for (int i = 0; i < 8; ++i)
+        buffer[56 + i] = static_cast<uint8_t>(bitLength >> (56 - i * 8));
+    compress(state, buffer);
+
+    Digest out;
+    for (int i = 0; i < 8; ++i) {
+        out[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return out;
+}
+
+SHA256::Digest SHA256::digest(const void* data, size_t len) {
+    StageTimer timer(MetricStage::Sha256);
+    Context ctx;
+    ctx.update(data, len);
+    return ctx.finish();
+}
+
+std::string SHA256::toHex(const Digest& digest) {
+    static const char* hex = "0123456789abcdef";
+    std::string out(DIGEST_SIZE * 2, '0');
+    for (size_t i = 0; i < DIGEST_SIZE; ++i) {
+        out[i * 2] = hex[digest[i] >> 4];
+        out[i * 2 + 1] = hex[digest[i] & 0x0F];
+    }
+    return out;
+}
+
+bool SHA256::fromHex(const std::string& hex, Digest& out) {
+    if (hex.size() != DIGEST_SIZE * 2) return false;
+    for (size_t i = 0; i < DIGEST_SIZE; ++i) {
+        int value = 0;
+        for (size_t j = 0; j < 2; ++j) {
+            char c = hex[i * 2 + j];
+            int nibble;
+            if (c >= '0' && c <= '9') nibble = c - '0';
+            else if (c >= 'a' && c <= 'f') nibble = 10 + (c - 'a');
+            else if (c >= 'A' && c <= 'F') nibble = 10 + (c - 'A');
+            else return false;
+            value = (value << 4) | nibble;
+        }
+        out[i] = static_cast<uint8_t>(value);
+    }
+    return true;
 }
 
 std::string SHA256::hash(const std::string& input) {
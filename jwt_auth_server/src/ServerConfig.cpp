@@ -0,0 +1,326 @@
+#include "../include/ServerConfig.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace {
+    /**
+     * @brief Разбирает целое в диапазоне [min, max].
+     */
+    template <typename T>
+    bool parseNumber(const std::string& value, T min, T max, T& out) {
+        long long parsed = 0;
+        const char* end = value.data() + value.size();
+        auto result = std::from_chars(value.data(), end, parsed);
+        if (result.ec != std::errc() || result.ptr != end) return false;
+        if (parsed < static_cast<long long>(min) || parsed > static_cast<long long>(max)) return false;
+        out = static_cast<T>(parsed);
+        return true;
+    }
+
+    bool parseEngine(const std::string& value, StorageEngine& out) {
+        if (value == "sqlite") out = StorageEngine::SQLite;
+        else if (value == "log") out = StorageEngine::MappedLog;
+        else return false;
+        return true;
+    }
+
+    bool parseAlgorithm(const std::string& value, PasswordAlgorithm& out) {
+        if (value == "pbkdf2") out = PasswordAlgorithm::PBKDF2;
+        else if (value == "balloon") out = PasswordAlgorithm::Balloon;
+        else if (value == "sha256") out = PasswordAlgorithm::LegacySHA256;
+        else return false;
+        return true;
+    }
+
+    bool parseHttpEngine(const std::string& value, HttpEngine& out) {
+        if (value == "httplib") out = HttpEngine::Httplib;
+        else if (value == "epoll") out = HttpEngine::Epoll;
+        else if (value == "io_uring") out = HttpEngine::Uring;
+        else return false;
+        return true;
+    }
+
+    /**
+     * @brief Разбирает `запросов/секунд` (например `20/60`); `0` выключает ограничение.
+     */
+    bool parseRateLimit(const std::string& value, RateLimit& out) {
+        if (value == "0") {
+            out.requests = 0;
+            return true;
+        }
+        size_t slash = value.find('/');
+        if (slash == std::string::npos) return false;
+        return parseNumber<uint32_t>(value.substr(0, slash), 1, 1000000, out.requests) &&
+               parseNumber<uint32_t>(value.substr(slash + 1), 1, 86400, out.periodSec);
+    }
+
+    std::string rateLimitText(const RateLimit& limit) {
+        if (limit.requests == 0) return "нет";
+        return std::to_string(limit.requests) + "/" + std::to_string(limit.periodSec) + " с";
+    }
+
+    const size_t MAX_SIZE = std::numeric_limits<int>::max();
+
+    /**
+     * @brief Описание одного параметра.
+     */
+    struct Option {
+        const char* name;   ///< Имя в файле и в командной строке.
+        const char* usage;  ///< Описание для --help.
+        bool (*apply)(const std::string& value, ServerSettings& s);
+    };
+
+    const Option OPTIONS[] = {
+        {"engine", "движок HTTP: httplib | epoll | io_uring",
+         [](const std::string& v, ServerSettings& s) { return parseHttpEngine(v, s.http.engine); }},
+        {"event-loops", "циклов событий epoll/io_uring, по одному на ядро (0 — по числу ядер)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 0, 1024, s.http.eventLoops); }},
+        {"host", "адрес прослушивания (0.0.0.0)",
+         [](const std::string& v, ServerSettings& s) { s.http.host = v; return !v.empty(); }},
+        {"port", "порт (8080)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 1, 65535, s.http.port); }},
+        {"workers", "потоков HTTP сверх hash-threads + hash-queue (0 — CPPHTTPLIB_THREAD_POOL_COUNT)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 0, 4096, s.http.workers); }},
+        {"max-queued-requests", "соединений в очереди к обработчикам, сверх — сброс (512, 0 — без ограничения)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 0, MAX_SIZE, s.http.maxQueuedRequests); }},
+        {"keep-alive-max", "запросов на одно keep-alive соединение (100)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 1, MAX_SIZE, s.http.keepAliveMaxCount); }},
+        {"keep-alive-timeout", "секунд простоя keep-alive соединения (5)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 0, 3600, s.http.keepAliveTimeoutSec); }},
+        {"read-timeout", "таймаут чтения запроса, с (5)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 1, 3600, s.http.readTimeoutSec); }},
+        {"write-timeout", "таймаут записи ответа, с (5)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 1, 3600, s.http.writeTimeoutSec); }},
+        {"listen-backlog", "очередь непринятых соединений (128)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 1, 65535, s.http.listenBacklog); }},
+        {"max-payload", "наибольший размер тела запроса, байт (65536)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 1, MAX_SIZE, s.http.payloadMaxBytes); }},
+        {"shutdown-timeout", "сколько при остановке ждать начатые запросы, с (10)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 0, 3600, s.http.shutdownTimeoutSec); }},
+        {"login-limit-ip", "попыток /login с одного IP: запросов/секунд (20/60, 0 — без ограничения)",
+         [](const std::string& v, ServerSettings& s) { return parseRateLimit(v, s.http.rateLimits.loginPerClient); }},
+        {"login-limit-user", "попыток /login на одно имя пользователя (10/60)",
+         [](const std::string& v, ServerSettings& s) { return parseRateLimit(v, s.http.rateLimits.loginPerUser); }},
+        {"register-limit-ip", "запросов /register с одного IP (10/60)",
+         [](const std::string& v, ServerSettings& s) { return parseRateLimit(v, s.http.rateLimits.registerPerClient); }},
+        {"register-limit-user", "запросов /register на одно имя пользователя (5/60)",
+         [](const std::string& v, ServerSettings& s) { return parseRateLimit(v, s.http.rateLimits.registerPerUser); }},
+        {"user-store", "хранилище пользователей: sqlite | log",
+         [](const std::string& v, ServerSettings& s) { return parseEngine(v, s.storage.userEngine); }},
+        {"revocation-store", "хранилище отозванных токенов: sqlite | log",
+         [](const std::string& v, ServerSettings& s) { return parseEngine(v, s.storage.revocationEngine); }},
+        {"sqlite-shards", "число шардов SQLite (1)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 1, 1024, s.storage.sqliteShards); }},
+        {"password-hash", "алгоритм хеширования паролей: pbkdf2 | balloon | sha256",
+         [](const std::string& v, ServerSettings& s) { return parseAlgorithm(v, s.passwordAlgorithm); }},
+        {"password-hash-ms", "подобрать стоимость хеша под это время, мс (0 — не подбирать)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 0, 60000, s.passwordHashMs); }},
+        {"hash-threads", "потоков хеширования паролей (0 — половина ядер)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 0, 1024, s.hashThreads); }},
+        {"hash-queue", "очередь задач хеширования (hash-threads * 4)",
+         [](const std::string& v, ServerSettings& s) {
+             size_t queue = 0;
+             if (!parseNumber<size_t>(v, 0, MAX_SIZE, queue)) return false;
+             s.hashQueue = queue;
+             return true;
+         }},
+        {"blacklist-cleanup-interval", "интервал очистки просроченных отзывов, с (60)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 1, 86400, s.blacklistCleanupIntervalSec); }},
+        {"blacklist-cleanup-batch", "строк, удаляемых за одну порцию очистки (500)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 1, 1000000, s.blacklistCleanupBatch); }},
+        {"write-batch-size", "наибольший размер пачки записей WriteQueue (64)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber<size_t>(v, 1, 65536, s.writeBatchSize); }},
+        {"write-batch-delay-us", "сколько ждать добора пачки записей, мкс (2000)",
+         [](const std::string& v, ServerSettings& s) { return parseNumber(v, 0, 1000000, s.writeBatchDelayUs); }},
+    };
+
+    const Option* findOption(const std::string& name) {
+        for (const Option& option : OPTIONS)
+            if (name == option.name) return &option;
+        return nullptr;
+    }
+
+    /**
+     * @brief `keep-alive-max` -> `JWT_KEEP_ALIVE_MAX`.
+     */
+    std::string envName(const char* name) {
+        std::string env = "JWT_";
+        for (const char* p = name; *p; ++p)
+            env += (*p == '-') ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(*p)));
+        return env;
+    }
+
+    bool applyOption(const std::string& name, const std::string& value, const std::string& source,
+                     ServerSettings& out) {
+        const Option* option = findOption(name);
+        if (!option) {
+            std::cerr << "[ServerConfig] Неизвестный параметр '" << name << "' (" << source << ")" << std::endl;
+            return false;
+        }
+        if (!option->apply(value, out)) {
+            std::cerr << "[ServerConfig] Некорректное значение " << name << " = '" << value
+                      << "' (" << source << ")" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::string trim(const std::string& s) {
+        size_t begin = 0, end = s.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(s[begin]))) ++begin;
+        while (end > begin && std::isspace(static_cast<unsigned char>(s[end - 1]))) --end;
+        return s.substr(begin, end - begin);
+    }
+
+    bool loadFile(const std::string& path, ServerSettings& out) {
+        std::ifstream in(path);
+        if (!in) {
+            std::cerr << "[ServerConfig] Не удалось открыть файл настроек " << path << std::endl;
+            return false;
+        }
+
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line.erase(hash);
+            line = trim(line);
+            if (line.empty()) continue;
+
+            std::string source = path + ":" + std::to_string(lineNo);
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) {
+                std::cerr << "[ServerConfig] Ожидается 'имя = значение' (" << source << ")" << std::endl;
+                return false;
+            }
+            if (!applyOption(trim(line.substr(0, eq)), trim(line.substr(eq + 1)), source, out)) return false;
+        }
+
+        std::cout << "[ServerConfig] Загружен файл настроек " << path << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Путь к файлу настроек: `--config` важнее `JWT_CONFIG`.
+     */
+    std::string configPath(int argc, char* argv[]) {
+        std::string path;
+        if (const char* env = std::getenv("JWT_CONFIG")) path = env;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--config" && i + 1 < argc) path = argv[i + 1];
+            else if (arg.rfind("--config=", 0) == 0) path = arg.substr(9);
+        }
+        return path;
+    }
+
+    const char* engineName(StorageEngine engine) {
+        return engine == StorageEngine::MappedLog ? "log" : "sqlite";
+    }
+
+    const char* httpEngineName(HttpEngine engine) {
+        switch (engine) {
+            case HttpEngine::Epoll: return "epoll";
+            case HttpEngine::Uring: return "io_uring";
+            default:                return "httplib";
+        }
+    }
+
+    const char* algorithmName(PasswordAlgorithm algorithm) {
+        switch (algorithm) {
+            case PasswordAlgorithm::Balloon: return "balloon";
+            case PasswordAlgorithm::LegacySHA256: return "sha256";
+            default: return "pbkdf2";
+        }
+    }
+}
+
+bool ServerConfig::load(int argc, char* argv[], ServerSettings& out) {
+    std::string path = configPath(argc, argv);
+    if (!path.empty() && !loadFile(path, out)) return false;
+
+    for (const Option& option : OPTIONS) {
+        std::string env = envName(option.name);
+        if (const char* value = std::getenv(env.c_str())) {
+            if (!applyOption(option.name, value, env, out)) return false;
+        }
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            std::cerr << "[ServerConfig] Неожиданный аргумент '" << arg << "'" << std::endl;
+            return false;
+        }
+
+        std::string name = arg.substr(2);
+        std::string value;
+        size_t eq = name.find('=');
+        if (eq != std::string::npos) {
+            value = name.substr(eq + 1);
+            name.erase(eq);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            std::cerr << "[ServerConfig] Не задано значение для --" << name << std::endl;
+            return false;
+        }
+
+        if (name == "config") continue;
+        if (!applyOption(name, value, "--" + name, out)) return false;
+    }
+
+    return true;
+}
+
+bool ServerConfig::helpRequested(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) return true;
+    }
+    return false;
+}
+
+void ServerConfig::printUsage(const char* program) {
+    std::cout << "Использование: " << program << " [--config файл] [--параметр значение]...\n\n"
+              << "Параметры (в файле: 'имя = значение', в окружении: JWT_<ИМЯ>):\n";
+    for (const Option& option : OPTIONS) {
+        std::string name = option.name;
+        name.resize(std::max<size_t>(name.size() + 2, 28), ' ');
+        std::cout << "  --" << name << option.usage << "\n";
+    }
+    std::cout << std::flush;
+}
+
+void ServerConfig::print(const ServerSettings& s) {
+    std::cout << "[ServerConfig] HTTP (" << httpEngineName(s.http.engine) << "): "
+              << s.http.host << ":" << s.http.port
+              << ", workers " << (s.http.workers ? std::to_string(s.http.workers) : "auto")
+              << ", очередь " << s.http.maxQueuedRequests
+              << ", keep-alive " << s.http.keepAliveMaxCount << " запросов / " << s.http.keepAliveTimeoutSec << " с"
+              << ", таймауты чтения/записи " << s.http.readTimeoutSec << "/" << s.http.writeTimeoutSec << " с"
+              << ", backlog " << s.http.listenBacklog
+              << ", тело до " << s.http.payloadMaxBytes << " байт"
+              << ", остановка до " << s.http.shutdownTimeoutSec << " с" << std::endl;
+    const RateLimitSettings& limits = s.http.rateLimits;
+    std::cout << "[ServerConfig] Лимиты: /login " << rateLimitText(limits.loginPerClient) << " на IP, "
+              << rateLimitText(limits.loginPerUser) << " на пользователя; /register "
+              << rateLimitText(limits.registerPerClient) << " на IP, "
+              << rateLimitText(limits.registerPerUser) << " на пользователя" << std::endl;
+    std::cout << "[ServerConfig] Хранилища: пользователи " << engineName(s.storage.userEngine)
+              << ", отзывы " << engineName(s.storage.revocationEngine)
+              << ", шардов SQLite " << s.storage.sqliteShards
+              << ", пачка записи " << s.writeBatchSize << " / " << s.writeBatchDelayUs << " мкс"
+              << ", очистка отзывов раз в " << s.blacklistCleanupIntervalSec << " с по "
+              << s.blacklistCleanupBatch << " строк" << std::endl;
+    std::cout << "[ServerConfig] Пароли: " << algorithmName(s.passwordAlgorithm)
+              << (s.passwordHashMs ? ", калибровка под " + std::to_string(s.passwordHashMs) + " мс" : "")
+              << ", потоков хеширования " << (s.hashThreads ? std::to_string(s.hashThreads) : "auto") << std::endl;
+}
@@ -0,0 +1,464 @@
+#include "../include/SqliteStore.h"
+#include "../include/Metrics.h"
+#include <sqlite3.h>
+#include <ctime>
+#include <iostream>
+#include <set>
+
+namespace {
+    /**
+     * @brief Открывает соединение и настраивает WAL и ожидание блокировок.
+     */
+    sqlite3* openConnection(const std::string& path, bool readOnly) {
+        sqlite3* conn = nullptr;
+        int flags = SQLITE_OPEN_FULLMUTEX |
+                    (readOnly ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE));
+        if (sqlite3_open_v2(path.c_str(), &conn, flags, nullptr) != SQLITE_OK) {
+            std::cerr << "Can't open database " << path << ": " << sqlite3_errmsg(conn) << "\n";
+            sqlite3_close(conn);
+            return nullptr;
+        }
+        sqlite3_busy_timeout(conn, 5000);
+        if (!readOnly)
+            sqlite3_exec(conn, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+        return conn;
+    }
+
+    bool createSchema(sqlite3* db) {
+        const char* create_users_sql = R"(
+            CREATE TABLE IF NOT EXISTS users (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                username TEXT UNIQUE NOT NULL,
+                password TEXT NOT NULL
+            );
+        )";
+
+        const char* create_blacklist_sql = R"(
+            CREATE TABLE IF NOT EXISTS blacklist (
+                token TEXT PRIMARY KEY,
+                expires_at INTEGER NOT NULL
+            );
+        )";
+
+        const char* create_blacklist_index_sql = R"(
+            CREATE INDEX IF NOT EXISTS idx_blacklist_expires_at ON blacklist (expires_at);
+        )";
+
+        char* errMsg = nullptr;
+
+        int rc = sqlite3_exec(db, create_users_sql, nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "SQL error (users): " << errMsg << "\n";
+            sqlite3_free(errMsg);
+            return false;
+        }
+
+        rc = sqlite3_exec(db, create_blacklist_sql, nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "SQL error (blacklist): " << errMsg << "\n";
+            sqlite3_free(errMsg);
+            return false;
+        }
+
+        rc = sqlite3_exec(db, create_blacklist_index_sql, nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "SQL error (blacklist index): " << errMsg << "\n";
+            sqlite3_free(errMsg);
+            return false;
+        }
+
+        return true;
+    }
+}
+
+SqliteStore::~SqliteStore() {
+    for (auto& shard : shards) {
+        if (shard->reader) sqlite3_close(shard->reader);
+        if (shard->writer) sqlite3_close(shard->writer);
+    }
+}
+
+std::vector<std::string> SqliteStore::shardPaths(const std::string& basePath, size_t count) {
+    if (count <= 1) return {basePath};
+
+    size_t slash = basePath.find_last_of('/');
+    size_t dot = basePath.find_last_of('.');
+    bool hasExt = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    std::string stem = hasExt ? basePath.substr(0, dot) : basePath;
+    std::string ext = hasExt ? basePath.substr(dot) : "";
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; ++i)
+        paths.push_back(stem + ".shard" + std::to_string(i) + ext);
+    return paths;
+}
+
+size_t SqliteStore::shardIndex(const std::string& key, size_t shardCount) {
+    // FNV-1a (64 бита): результат не зависит от платформы и версии стандартной библиотеки,
+    // поэтому распределение по шардам стабильно между перезапусками.
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return shardCount ? static_cast<size_t>(h % shardCount) : 0;
+}
+
+SqliteStore::Shard& SqliteStore::shardFor(const std::string& key) {
+    return *shards[shardIndex(key, shards.size())];
+}
+
+bool SqliteStore::open(const std::string& db_path) {
+    return open(std::vector<std::string>{db_path});
+}
+
+bool SqliteStore::open(const std::vector<std::string>& shard_paths) {
+    for (const std::string& path : shard_paths) {
+        auto shard = std::make_unique<Shard>();
+        shard->writer = openConnection(path, false);
+        if (!shard->writer || !createSchema(shard->writer)) {
+            if (shard->writer) sqlite3_close(shard->writer);
+            return false;
+        }
+        shard->reader = openConnection(path, true);
+        if (!shard->reader) {
+            sqlite3_close(shard->writer);
+            return false;
+        }
+        shards.push_back(std::move(shard));
+    }
+
+    if (shards.size() > 1)
+        std::cout << "[SqliteStore] Открыто шардов: " << shards.size() << "\n";
+    return !shards.empty();
+}
+
+bool SqliteStore::insertUser(const std::string& username, const std::string& passwordHash) {
+    StageTimer timer(MetricStage::Sqlite);
+    Shard& shard = shardFor(username);
+    const char* sql = "INSERT INTO users (username, password) VALUES (?, ?);";
+
+    std::lock_guard<std::mutex> lock(shard.write_mutex);
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(shard.writer, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+
+    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, passwordHash.c_str(), -1, SQLITE_TRANSIENT);
+
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+LookupResult SqliteStore::findUser(const std::string& username, User& user_out) {
+    StageTimer timer(MetricStage::Sqlite);
+    size_t index = shardIndex(username, shards.size());
+    Shard& shard = *shards[index];
+    const char* sql = "SELECT id, username, password FROM users WHERE username = ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(shard.reader, sql, -1, &stmt, nullptr) != SQLITE_OK) return LookupResult::Error;
+
+    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_TRANSIENT);
+
+    LookupResult result = LookupResult::Error;
+    int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW) {
+        // Идентификатор уникален в пределах всех шардов; при одном шарде совпадает с rowid.
+        int localId = sqlite3_column_int(stmt, 0);
+        user_out.id = (localId - 1) * static_cast<int>(shards.size()) + static_cast<int>(index) + 1;
+        user_out.username = (const char*)sqlite3_column_text(stmt, 1);
+        user_out.password = (const char*)sqlite3_column_text(stmt, 2);
+        result = LookupResult::Found;
+    } else if (rc == SQLITE_DONE) {
+        result = LookupResult::NotFound;
+    }
+
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+// ===========================
+// BLACKLIST METHODS
+// ===========================
+
+bool SqliteStore::blacklistToken(const std::string& token, uint64_t expires_at) {
+    StageTimer timer(MetricStage::Sqlite);
+    Shard& shard = shardFor(token);
+    const char* sql = "INSERT OR IGNORE INTO blacklist (token, expires_at) VALUES (?, ?);";
+
+    std::lock_guard<std::mutex> lock(shard.write_mutex);
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(shard.writer, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+
+    sqlite3_bind_text(stmt, 1, token.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(expires_at));
+
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+bool SqliteStore::isTokenBlacklisted(const std::string& token) {
+    StageTimer timer(MetricStage::Sqlite);
+    Shard& shard = shardFor(token);
+    const char* sql = "SELECT 1 FROM blacklist WHERE token = ? LIMIT 1;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(shard.reader, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+
+    sqlite3_bind_text(stmt, 1, token.c_str(), -1, SQLITE_TRANSIENT);
+
+    bool found = (sqlite3_step(stmt) == SQLITE_ROW);
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+bool SqliteStore::findBlacklisted(const std::vector<std::string>& tokens, std::vector<bool>& revoked) {
+    StageTimer timer(MetricStage::Sqlite);
+    revoked.assign(tokens.size(), false);
+
+    std::vector<std::vector<size_t>> byShard(shards.size());
+    for (size_t i = 0; i < tokens.size(); ++i)
+        byShard[shardIndex(tokens[i], shards.size())].push_back(i);
+
+    // Один подготовленный запрос на шард, переиспользуемый для всех его токенов.
+    const char* sql = "SELECT 1 FROM blacklist WHERE token = ? LIMIT 1;";
+    for (size_t s = 0; s < shards.size(); ++s) {
+        if (byShard[s].empty()) continue;
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(shards[s]->reader, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+
+        bool ok = true;
+        for (size_t i : byShard[s]) {
+            sqlite3_bind_text(stmt, 1, tokens[i].c_str(), -1, SQLITE_STATIC);
+            int rc = sqlite3_step(stmt);
+            if (rc == SQLITE_ROW) revoked[i] = true;
+            else if (rc != SQLITE_DONE) ok = false;
+            sqlite3_reset(stmt);
+            if (!ok) break;
+        }
+        sqlite3_finalize(stmt);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+int SqliteStore::purgeExpired(int batchSize, uint64_t now) {
+    StageTimer timer(MetricStage::Sqlite);
+    const char* sql = R"(
+        DELETE FROM blacklist WHERE rowid IN (
+            SELECT rowid FROM blacklist WHERE expires_at < ? ORDER BY expires_at LIMIT ?
+        );
+    )";
+
+    // Порция набирается по шардам по кругу; блокировка берётся только на шард.
+    int deleted = 0;
+    size_t start = purge_cursor++;
+    for (size_t i = 0; i < shards.size() && deleted < batchSize; ++i) {
+        Shard& shard = *shards[(start + i) % shards.size()];
+
+        std::lock_guard<std::mutex> lock(shard.write_mutex);
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(shard.writer, sql, -1, &stmt, nullptr) != SQLITE_OK) return -1;
+
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(now));
+        sqlite3_bind_int(stmt, 2, batchSize - deleted);
+
+        bool ok = (sqlite3_step(stmt) == SQLITE_DONE);
+        if (ok) deleted += sqlite3_changes(shard.writer);
+        sqlite3_finalize(stmt);
+        if (!ok) return -1;
+    }
+    return deleted;
+}
+
+// ===========================
+// BATCH WRITES
+// ===========================
+
+bool SqliteStore::applyBatch(const std::vector<WriteOp>& ops, std::vector<bool>& results) {
+    StageTimer timer(MetricStage::Sqlite);
+    results.assign(ops.size(), false);
+    if (ops.empty()) return true;
+
+    std::vector<std::vector<const WriteOp*>> perShard(shards.size());
+    std::vector<std::vector<size_t>> positions(shards.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        size_t index = shardIndex(ops[i].key, shards.size());
+        perShard[index].push_back(&ops[i]);
+        positions[index].push_back(i);
+    }
+
+    bool committed = true;
+    std::vector<bool> partial;
+    for (size_t s = 0; s < shards.size(); ++s) {
+        if (perShard[s].empty()) continue;
+        committed &= applyShardBatch(*shards[s], perShard[s], partial);
+        for (size_t i = 0; i < positions[s].size(); ++i)
+            results[positions[s][i]] = partial[i];
+    }
+    return committed;
+}
+
+bool SqliteStore::applyShardBatch(Shard& shard, const std::vector<const WriteOp*>& ops, std::vector<bool>& results) {
+    results.assign(ops.size(), false);
+    sqlite3* db = shard.writer;
+
+    const char* insert_user_sql = "INSERT INTO users (username, password) VALUES (?, ?);";
+    const char* update_password_sql = "UPDATE users SET password = ? WHERE username = ?;";
+    const char* blacklist_sql = "INSERT OR IGNORE INTO blacklist (token, expires_at) VALUES (?, ?);";
+
+    std::lock_guard<std::mutex> lock(shard.write_mutex);
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "[SqliteStore] BEGIN failed: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
+    sqlite3_stmt* insertUserStmt = nullptr;
+    sqlite3_stmt* updatePasswordStmt = nullptr;
+    sqlite3_stmt* blacklistStmt = nullptr;
+
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const WriteOp& op = *ops[i];
+        sqlite3_stmt* stmt = nullptr;
+
+        if (op.type == WriteOp::Type::InsertUser) {
+            if (!insertUserStmt && sqlite3_prepare_v2(db, insert_user_sql, -1, &insertUserStmt, nullptr) != SQLITE_OK)
+                continue;
+            stmt = insertUserStmt;
+            sqlite3_bind_text(stmt, 1, op.key.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, op.value.c_str(), -1, SQLITE_TRANSIENT);
+        } else if (op.type == WriteOp::Type::UpdatePassword) {
+            if (!updatePasswordStmt && sqlite3_prepare_v2(db, update_password_sql, -1, &updatePasswordStmt, nullptr) != SQLITE_OK)
+                continue;
+            stmt = updatePasswordStmt;
+            sqlite3_bind_text(stmt, 1, op.value.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, op.key.c_str(), -1, SQLITE_TRANSIENT);
+        } else {
+            if (!blacklistStmt && sqlite3_prepare_v2(db, blacklist_sql, -1, &blacklistStmt, nullptr) != SQLITE_OK)
+                continue;
+            stmt = blacklistStmt;
+            sqlite3_bind_text(stmt, 1, op.key.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(op.expiresAt));
+        }
+
+        results[i] = (sqlite3_step(stmt) == SQLITE_DONE);
+        if (results[i] && op.type == WriteOp::Type::UpdatePassword)
+            results[i] = sqlite3_changes(db) > 0;
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+
+    sqlite3_finalize(insertUserStmt);
+    sqlite3_finalize(updatePasswordStmt);
+    sqlite3_finalize(blacklistStmt);
+
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "[SqliteStore] COMMIT failed: " << sqlite3_errmsg(db) << "\n";
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        results.assign(ops.size(), false);
+        return false;
+    }
+
+    return true;
+}
+
+// ===========================
+// RESHARDING
+// ===========================
+
+bool SqliteStore::reshard(const std::string& srcBase, size_t srcShards,
+                          const std::string& dstBase, size_t dstShards) {
+    std::vector<std::string> srcPaths = shardPaths(srcBase, srcShards);
+    std::vector<std::string> dstPaths = shardPaths(dstBase, dstShards);
+
+    std::set<std::string> srcSet(srcPaths.begin(), srcPaths.end());
+    for (const std::string& path : dstPaths) {
+        if (srcSet.count(path)) {
+            std::cerr << "[reshard] Целевой файл совпадает с исходным: " << path << "\n";
+            return false;
+        }
+    }
+
+    // Исходные шарды открываются только на чтение: без создания файлов, WAL и схемы.
+    std::vector<sqlite3*> sources;
+    auto closeSources = [&]() {
+        for (sqlite3* conn : sources) sqlite3_close(conn);
+    };
+    for (const std::string& path : srcPaths) {
+        sqlite3* conn = openConnection(path, true);
+        if (!conn) {
+            std::cerr << "[reshard] Исходный шард недоступен: " << path << "\n";
+            closeSources();
+            return false;
+        }
+        sources.push_back(conn);
+    }
+
+    SqliteStore dst;
+    if (!dst.open(dstPaths)) {
+        closeSources();
+        return false;
+    }
+
+    const size_t chunk = 1000;
+    uint64_t now = static_cast<uint64_t>(std::time(nullptr));
+    size_t users = 0, tokens = 0, failed = 0;
+
+    std::vector<WriteOp> batch;
+    std::vector<bool> results;
+    auto flush = [&]() {
+        if (batch.empty()) return;
+        dst.applyBatch(batch, results);
+        for (bool ok : results) failed += ok ? 0 : 1;
+        batch.clear();
+    };
+
+    bool readOk = true;
+    for (sqlite3* conn : sources) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(conn, "SELECT username, password FROM users ORDER BY id;",
+                               -1, &stmt, nullptr) != SQLITE_OK) {
+            readOk = false;
+            break;
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            WriteOp op;
+            op.type = WriteOp::Type::InsertUser;
+            op.key = (const char*)sqlite3_column_text(stmt, 0);
+            op.value = (const char*)sqlite3_column_text(stmt, 1);
+            batch.push_back(std::move(op));
+            users++;
+            if (batch.size() >= chunk) flush();
+        }
+        sqlite3_finalize(stmt);
+
+        if (sqlite3_prepare_v2(conn, "SELECT token, expires_at FROM blacklist WHERE expires_at >= ?;",
+                               -1, &stmt, nullptr) != SQLITE_OK) {
+            readOk = false;
+            break;
+        }
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(now));
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            WriteOp op;
+            op.type = WriteOp::Type::BlacklistToken;
+            op.key = (const char*)sqlite3_column_text(stmt, 0);
+            op.expiresAt = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+            batch.push_back(std::move(op));
+            tokens++;
+            if (batch.size() >= chunk) flush();
+        }
+        sqlite3_finalize(stmt);
+    }
+    closeSources();
+    if (!readOk) {
+        std::cerr << "[reshard] Не удалось прочитать исходную базу (нет таблиц users/blacklist?)\n";
+        return false;
+    }
+    flush();
+
+    std::cout << "[reshard] " << srcShards << " -> " << dstShards << " шардов: пользователей "
+              << users << ", токенов " << tokens << ", ошибок " << failed << "\n";
+    return failed == 0;
+}
@@ -0,0 +1,116 @@
+#include "../include/StaticResponse.h"
+#include "../include/HttpProtocol.h"
+
+#include <array>
+#include <iostream>
+#include <vector>
+
+namespace {
+    using Table = std::array<StaticResponse, static_cast<size_t>(StaticResponseId::Count)>;
+
+    /**
+     * @brief Описание шаблона до сериализации.
+     */
+    struct Template {
+        StaticResponseId id;
+        int status;
+        const char* body;                ///< nullptr — без тела.
+        httplib::Headers headers;
+    };
+
+    Table build() {
+        const std::vector<Template> templates = {
+            {StaticResponseId::Preflight, 200, nullptr,
+             {{"Access-Control-Allow-Methods", "POST, GET, OPTIONS"},
+              {"Access-Control-Allow-Headers", "Content-Type, Authorization"}}},
+            {StaticResponseId::UserRegistered, 201, "User registered successfully", {}},
+            {StaticResponseId::LoggedOut, 200, "Logged out successfully", {}},
+            {StaticResponseId::MissingCredentials, 400, "Missing 'username' or 'password'", {}},
+            {StaticResponseId::MissingAuthorization, 400, "Missing Authorization header", {}},
+            {StaticResponseId::InvalidAuthorization, 400, "Invalid Authorization header format", {}},
+            {StaticResponseId::InvalidAccessAuthorization, 400, "Invalid Authorization format", {}},
+            {StaticResponseId::MissingAccessAuthorization, 401, "Missing 'Authorization' header", {}},
+            {StaticResponseId::InvalidCredentials, 401, "Invalid credentials", {}},
+            {StaticResponseId::InvalidAccessToken, 401, "Invalid or expired access token", {}},
+            {StaticResponseId::InvalidRefreshToken, 401, "Invalid or expired refresh token", {}},
+            {StaticResponseId::RefreshTokenBlacklisted, 403, "Refresh token is blacklisted", {}},
+            {StaticResponseId::InvalidIntrospectRequest, 400, "Expected {\"tokens\": [\"<jwt>\", ...]}", {}},
+            {StaticResponseId::TooManyTokens, 413, "Too many tokens", {}},
+            {StaticResponseId::UserExists, 409, "Username already exists", {}},
+            {StaticResponseId::KeyError, 500, "Key error", {}},
+            {StaticResponseId::DatabaseError, 500, "Database error", {}},
+            {StaticResponseId::ServerBusy, 503, "Server busy, try again later", {{"Retry-After", "1"}}},
+            {StaticResponseId::BadRequest, 400, nullptr, {}},
+            {StaticResponseId::NotFound, 404, nullptr, {}},
+            {StaticResponseId::LengthRequired, 411, nullptr, {}},
+            {StaticResponseId::PayloadTooLarge, 413, nullptr, {}},
+            {StaticResponseId::HeadersTooLarge, 431, nullptr, {}},
+            {StaticResponseId::InternalError, 500, nullptr, {}},
+            {StaticResponseId::VersionNotSupported, 505, nullptr, {}},
+        };
+
+        Table table;
+        for (const Template& t : templates)
+            table[static_cast<size_t>(t.id)] = StaticResponses::make(t.status, t.body ? t.body : "", "text/plain",
+                                                                     t.headers);
+        return table;
+    }
+
+    const Table& table() {
+        static const Table instance = build();
+        return instance;
+    }
+}
+
+void StaticResponses::prepare() {
+    size_t bytes = 0;
+    for (const StaticResponse& response : table()) bytes += response.keepAliveWire.size() + response.closeWire.size();
+    std::cout << "[StaticResponses] Подготовлено " << table().size() << " фиксированных ответов ("
+              << bytes << " байт)" << std::endl;
+}
+
+const StaticResponse& StaticResponses::get(StaticResponseId id) {
+    return table()[static_cast<size_t>(id)];
+}
+
+const StaticResponse& StaticResponses::forStatus(int status) {
+    switch (status) {
+        case 404: return get(StaticResponseId::NotFound);
+        case 411: return get(StaticResponseId::LengthRequired);
+        case 413: return get(StaticResponseId::PayloadTooLarge);
+        case 431: return get(StaticResponseId::HeadersTooLarge);
+        case 500: return get(StaticResponseId::InternalError);
+        case 505: return get(StaticResponseId::VersionNotSupported);
+        default:  return get(StaticResponseId::BadRequest);
+    }
+}
+
+const httplib::Headers& StaticResponses::commonHeaders() {
+    static const httplib::Headers headers = {{"Access-Control-Allow-Origin", "*"}};
+    return headers;
+}
+
+StaticResponse StaticResponses::make(int status, const std::string& body, const std::string& contentType,
+                                     const httplib::Headers& headers) {
+    StaticResponse out;
+    out.status = status;
+    out.headers = headers;
+    if (!body.empty()) {
+        out.body = body;
+        out.contentType = contentType;
+    }
+
+    httplib::Response res;
+    res.status = out.status;
+    res.headers = out.headers;
+    if (!out.body.empty()) res.set_content(out.body, out.contentType);
+    HttpProtocol::serialize(res, true, out.keepAliveWire);
+    HttpProtocol::serialize(res, false, out.closeWire);
+    return out;
+}
+
+void StaticResponses::apply(const StaticResponse& response, httplib::Response& res) {
+    res.status = response.status;
+    for (const auto& header : response.headers) res.set_header(header.first, header.second);
+    if (!response.body.empty()) res.set_content(response.body, response.contentType);
+}
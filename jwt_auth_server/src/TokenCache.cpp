@@ -0,0 +1,131 @@
+#include "../include/TokenCache.h"
+#include "../include/SHA256.h"
+
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Хеш ключа для unordered_map: ключ уже равномерно распределён (SHA-256).
+     */
+    struct DigestHash {
+        size_t operator()(const SHA256::Digest& d) const {
+            size_t h;
+            std::memcpy(&h, d.data() + 8, sizeof(h));
+            return h;
+        }
+    };
+
+    struct Entry {
+        SHA256::Digest key;
+        std::string subject;
+        uint64_t expiresAt;
+    };
+
+    /**
+     * @brief Шард: LRU-список (голова — самая свежая запись) и индекс по ключу.
+     */
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> order;
+        std::unordered_map<SHA256::Digest, std::list<Entry>::iterator, DigestHash> index;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t capacity_per_shard = 0;
+
+    std::atomic<uint64_t> stat_hits{0};
+    std::atomic<uint64_t> stat_misses{0};
+    std::atomic<uint64_t> stat_expired{0};
+    std::atomic<uint64_t> stat_evictions{0};
+
+    Shard* shardFor(const SHA256::Digest& key) {
+        if (shards.empty() || capacity_per_shard == 0) return nullptr;
+        uint64_t h;
+        std::memcpy(&h, key.data(), sizeof(h));
+        return shards[h % shards.size()].get();
+    }
+
+    struct DefaultConfig {
+        DefaultConfig() { TokenCache::configure(100000, 16); }
+    } default_config;
+}
+
+void TokenCache::configure(size_t capacity, size_t shardCount) {
+    if (shardCount == 0) shardCount = 1;
+
+    shards.clear();
+    for (size_t i = 0; i < shardCount; ++i)
+        shards.push_back(std::make_unique<Shard>());
+
+    capacity_per_shard = (capacity + shardCount - 1) / shardCount;
+}
+
+bool TokenCache::lookup(std::string_view token, uint64_t now, std::string& outSubject, uint64_t& outExpiresAt) {
+    SHA256::Digest key = SHA256::digest(token.data(), token.size());
+    Shard* shard = shardFor(key);
+    if (!shard) {
+        stat_misses++;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    auto it = shard->index.find(key);
+    if (it == shard->index.end()) {
+        stat_misses++;
+        return false;
+    }
+
+    if (now > it->second->expiresAt) {
+        shard->order.erase(it->second);
+        shard->index.erase(it);
+        stat_expired++;
+        return false;
+    }
+
+    shard->order.splice(shard->order.begin(), shard->order, it->second);
+    outSubject = it->second->subject;
+    outExpiresAt = it->second->expiresAt;
+    stat_hits++;
+    return true;
+}
+
+void TokenCache::put(std::string_view token, const std::string& subject, uint64_t expiresAt) {
+    SHA256::Digest key = SHA256::digest(token.data(), token.size());
+    Shard* shard = shardFor(key);
+    if (!shard) return;
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    if (shard->index.count(key)) return;
+
+    shard->order.push_front(Entry{key, subject, expiresAt});
+    shard->index.emplace(key, shard->order.begin());
+
+    if (shard->index.size() > capacity_per_shard) {
+        shard->index.erase(shard->order.back().key);
+        shard->order.pop_back();
+        stat_evictions++;
+    }
+}
+
+void TokenCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->order.clear();
+        shard->index.clear();
+    }
+}
+
+TokenCacheStats TokenCache::getStats() {
+    TokenCacheStats stats;
+    stats.hits = stat_hits.load();
+    stats.misses = stat_misses.load();
+    stats.expired = stat_expired.load();
+    stats.evictions = stat_evictions.load();
+    return stats;
+}
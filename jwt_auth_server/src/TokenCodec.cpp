@@ -0,0 +1,304 @@
+#include "../include/TokenCodec.h"
+#include "../include/JWT.h"
+#include "../include/JwtView.h"
+#include "../include/Base64URL.h"
+#include "../include/SHA256.h"
+#include "../include/Json.h"
+#include "../include/TokenCache.h"
+#include "../include/Metrics.h"
+
+#include <charconv>
+#include <ctime>
+#include <iostream>
+
+namespace {
+    const size_t MAX_PAYLOAD_BYTES = 2048;    ///< Предел декодированного payload (буфер на стеке).
+    const size_t MAX_SIGNATURE_BYTES = 1024;  ///< Предел декодированной hex-строки подписи.
+
+    /**
+     * @brief Строка фиксированной ёмкости, собираемая на этапе компиляции.
+     */
+    template <size_t N>
+    struct Literal {
+        char data[N] = {};
+        size_t size = 0;
+
+        constexpr void append(std::string_view s) {
+            for (char c : s) data[size++] = c;
+        }
+
+        constexpr std::string_view view() const { return std::string_view(data, size); }
+    };
+
+    constexpr std::string_view BASE64URL_ALPHABET =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    /**
+     * @brief Base64URL на этапе компиляции.
+     *
+     * @param wholeGroupsOnly Кодировать только полные тройки байт — их кодировка
+     *        не зависит от следующих за префиксом данных.
+     */
+    constexpr Literal<64> base64Url(std::string_view in, bool wholeGroupsOnly) {
+        Literal<64> out;
+        size_t whole = in.size() / 3 * 3;
+        for (size_t i = 0; i < whole; i += 3) {
+            uint32_t v = (static_cast<uint8_t>(in[i]) << 16) | (static_cast<uint8_t>(in[i + 1]) << 8) |
+                         static_cast<uint8_t>(in[i + 2]);
+            out.data[out.size++] = BASE64URL_ALPHABET[(v >> 18) & 0x3F];
+            out.data[out.size++] = BASE64URL_ALPHABET[(v >> 12) & 0x3F];
+            out.data[out.size++] = BASE64URL_ALPHABET[(v >> 6) & 0x3F];
+            out.data[out.size++] = BASE64URL_ALPHABET[v & 0x3F];
+        }
+        if (!wholeGroupsOnly && whole < in.size()) {
+            uint32_t v = static_cast<uint8_t>(in[whole]) << 16;
+            if (whole + 1 < in.size()) v |= static_cast<uint8_t>(in[whole + 1]) << 8;
+            out.data[out.size++] = BASE64URL_ALPHABET[(v >> 18) & 0x3F];
+            out.data[out.size++] = BASE64URL_ALPHABET[(v >> 12) & 0x3F];
+            if (whole + 1 < in.size()) out.data[out.size++] = BASE64URL_ALPHABET[(v >> 6) & 0x3F];
+        }
+        return out;
+    }
+
+    constexpr std::string_view TYP_KEY = "{\"typ\":\"";
+
+    constexpr Literal<32> payloadPrefix(std::string_view typ) {
+        Literal<32> prefix;
+        prefix.append(TYP_KEY);
+        prefix.append(typ);
+        prefix.append("\",");
+        return prefix;
+    }
+
+    /// `{"typ":"<вид>",` — начало payload каждого токена нового формата.
+    template <TokenKind Kind>
+    constexpr Literal<32> PAYLOAD_PREFIX = payloadPrefix(TokenTraits<Kind>::typ);
+
+    /// Закодированное начало payload, определяемое префиксом однозначно.
+    template <TokenKind Kind>
+    constexpr Literal<64> ENCODED_PAYLOAD_PREFIX = base64Url(PAYLOAD_PREFIX<Kind>.view(), true);
+
+    /// Закодированный `{"typ":"` — общий для всех видов токенов нового формата.
+    constexpr Literal<64> ENCODED_TYP_KEY = base64Url(TYP_KEY, true);
+
+    /// Закодированный заголовок алгоритма.
+    template <SignatureAlgorithm Algorithm>
+    constexpr Literal<64> ENCODED_HEADER = base64Url(AlgorithmTraits<Algorithm>::header, false);
+
+    bool startsWith(std::string_view s, std::string_view prefix) {
+        return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    void appendNumber(std::string& out, uint64_t value) {
+        char digits[20];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    /**
+     * @brief Кодирует в Base64URL хвост out, начиная с позиции start, на месте.
+     *
+     * Тройки обрабатываются с конца: каждая четвёрка символов ложится не левее
+     * своей тройки байт, поэтому ещё не закодированные данные не затираются.
+     */
+    void encodeTailInPlace(std::string& out, size_t start) {
+        StageTimer timer(MetricStage::Base64Encode);
+        size_t n = out.size() - start;
+        size_t whole = n / 3;
+        size_t rest = n % 3;
+        out.resize(start + Base64URL::encodedSize(n));
+        char* p = &out[start];
+
+        if (rest) {
+            uint32_t v = static_cast<uint8_t>(p[whole * 3]) << 16;
+            if (rest == 2) v |= static_cast<uint8_t>(p[whole * 3 + 1]) << 8;
+            char* o = p + whole * 4;
+            o[0] = BASE64URL_ALPHABET[(v >> 18) & 0x3F];
+            o[1] = BASE64URL_ALPHABET[(v >> 12) & 0x3F];
+            if (rest == 2) o[2] = BASE64URL_ALPHABET[(v >> 6) & 0x3F];
+        }
+        for (size_t i = whole; i-- > 0;) {
+            uint32_t v = (static_cast<uint8_t>(p[i * 3]) << 16) | (static_cast<uint8_t>(p[i * 3 + 1]) << 8) |
+                         static_cast<uint8_t>(p[i * 3 + 2]);
+            char* o = p + i * 4;
+            o[0] = BASE64URL_ALPHABET[(v >> 18) & 0x3F];
+            o[1] = BASE64URL_ALPHABET[(v >> 12) & 0x3F];
+            o[2] = BASE64URL_ALPHABET[(v >> 6) & 0x3F];
+            o[3] = BASE64URL_ALPHABET[v & 0x3F];
+        }
+    }
+
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+        return -1;
+    }
+
+    /**
+     * @brief Переводит hex-строку подписи в байты (big-endian).
+     *
+     * Подпись пишется через BigInt::toString(16) без ведущих нулей,
+     * поэтому длина строки может быть нечётной.
+     */
+    bool hexToBytes(std::string_view hex, uint8_t* out, size_t capacity, size_t& outLen) {
+        if (hex.empty()) return false;
+        outLen = (hex.size() + 1) / 2;
+        if (outLen > capacity) return false;
+
+        size_t i = 0;
+        size_t o = 0;
+        if (hex.size() % 2 != 0) {
+            int v = hexValue(hex[i++]);
+            if (v < 0) return false;
+            out[o++] = static_cast<uint8_t>(v);
+        }
+        for (; i < hex.size(); i += 2) {
+            int hi = hexValue(hex[i]);
+            int lo = hexValue(hex[i + 1]);
+            if (hi < 0 || lo < 0) return false;
+            out[o++] = static_cast<uint8_t>((hi << 4) | lo);
+        }
+        return true;
+    }
+}
+
+template <TokenKind Kind, SignatureAlgorithm Algorithm>
+std::string TokenCodec<Kind, Algorithm>::create(const std::string& subject, uint64_t expirationSeconds,
+                                                const PrivateKey& privKey) {
+    uint64_t now = std::time(nullptr);
+
+    std::string escapedSubject;
+    Json::escape(subject, escapedSubject);
+
+    std::string message;
+    message.reserve(signingInputCapacity(escapedSubject.size()));
+    appendSigningInput(message, escapedSubject, now, now + expirationSeconds);
+
+    return sign(message, privKey);
+}
+
+template <TokenKind Kind, SignatureAlgorithm Algorithm>
+size_t TokenCodec<Kind, Algorithm>::signingInputCapacity(size_t escapedSubjectLen) {
+    // {"typ":"..","sub":"<subject>","iat":<20 цифр>,"exp":<20 цифр>}
+    size_t payloadLen = PAYLOAD_PREFIX<Kind>.size + 7 + escapedSubjectLen + 8 + 20 + 7 + 20 + 1;
+    return ENCODED_HEADER<Algorithm>.size + 1 + Base64URL::encodedSize(payloadLen);
+}
+
+template <TokenKind Kind, SignatureAlgorithm Algorithm>
+void TokenCodec<Kind, Algorithm>::appendSigningInput(std::string& out, std::string_view escapedSubject,
+                                                     uint64_t issuedAt, uint64_t expiresAt) {
+    out += ENCODED_HEADER<Algorithm>.view();
+    out += '.';
+
+    // Payload пишется прямо в out и кодируется на месте.
+    size_t payloadStart = out.size();
+    out += PAYLOAD_PREFIX<Kind>.view();
+    out += "\"sub\":\"";
+    out += escapedSubject;
+    out += "\",\"iat\":";
+    appendNumber(out, issuedAt);
+    out += ",\"exp\":";
+    appendNumber(out, expiresAt);
+    out += '}';
+    encodeTailInPlace(out, payloadStart);
+}
+
+template <TokenKind Kind, SignatureAlgorithm Algorithm>
+std::string TokenCodec<Kind, Algorithm>::sign(std::string_view signingInput, const PrivateKey& privKey) {
+    SHA256::Digest hash = SHA256::digest(signingInput.data(), signingInput.size());
+    BigInt hashInt(SHA256::toHex(hash), 16);
+    BigInt signatureInt = RSA::sign(hashInt, privKey);
+    std::string signatureHex = signatureInt.toString(16);
+
+    std::string token;
+    token.reserve(signingInput.size() + 1 + Base64URL::encodedSize(signatureHex.size()));
+    token += signingInput;
+    token += '.';
+    Base64URL::encode(signatureHex, token);
+    return token;
+}
+
+template <TokenKind Kind, SignatureAlgorithm Algorithm>
+bool TokenCodec<Kind, Algorithm>::verify(std::string_view token, const PublicKey& pubKey,
+                                         std::string& outSubject, uint64_t& outExpiresAt) {
+    // Повторно предъявленный access токен уже проверялся — достаточно хеша и поиска в кэше.
+    // Refresh токены не кэшируются: они предъявляются редко и сверяются с чёрным списком.
+    if constexpr (Kind == TokenKind::Access) {
+        if (TokenCache::lookup(token, std::time(nullptr), outSubject, outExpiresAt)) return true;
+    }
+
+    JwtView view;
+    if (!JwtView::parse(token, view)) {
+        std::cerr << "[JWT] Токен не состоит из трёх сегментов" << std::endl;
+        return false;
+    }
+
+    if (view.header != ENCODED_HEADER<Algorithm>.view()) {
+        std::cerr << "[JWT] Неподдерживаемый заголовок токена" << std::endl;
+        return false;
+    }
+
+    // Вид токена нового формата известен по фиксированному префиксу payload — без декодирования и RSA.
+    bool fixedLayout = startsWith(view.payload, ENCODED_PAYLOAD_PREFIX<Kind>.view());
+    if (!fixedLayout && startsWith(view.payload, ENCODED_TYP_KEY.view())) {
+        std::cerr << "[JWT] Токен не является " << Traits::typ << std::endl;
+        return false;
+    }
+
+    char sigHex[MAX_SIGNATURE_BYTES];
+    size_t sigHexLen = 0;
+    uint8_t signature[MAX_SIGNATURE_BYTES / 2];
+    size_t signatureLen = 0;
+    if (!Base64URL::decode(view.signature, sigHex, sizeof(sigHex), sigHexLen) ||
+        !hexToBytes(std::string_view(sigHex, sigHexLen), signature, sizeof(signature), signatureLen)) {
+        std::cerr << "[JWT] Подпись " << Traits::typ << " токена повреждена" << std::endl;
+        return false;
+    }
+
+    SHA256::Digest expectedHash = SHA256::digest(view.signingInput.data(), view.signingInput.size());
+
+    if (!RSA::verify(expectedHash, signature, signatureLen, pubKey)) {
+        std::cerr << "[JWT] Подпись " << Traits::typ << " токена недействительна" << std::endl;
+        return false;
+    }
+
+    char payloadBuf[MAX_PAYLOAD_BYTES];
+    size_t payloadLen = 0;
+    if (!Base64URL::decode(view.payload, payloadBuf, sizeof(payloadBuf), payloadLen)) {
+        std::cerr << "[JWT] Payload " << Traits::typ << " токена повреждён" << std::endl;
+        return false;
+    }
+    std::string_view payloadJson(payloadBuf, payloadLen);
+
+    JwtClaims claims;
+    if (!JWT::parseClaims(payloadJson, claims)) {
+        std::cerr << "[JWT] Payload " << Traits::typ << " токена не является корректным JSON" << std::endl;
+        return false;
+    }
+
+    bool kindMatches = fixedLayout ? startsWith(payloadJson, PAYLOAD_PREFIX<Kind>.view())
+                                   : (claims.typ.present && claims.typ.view() == Traits::typ);
+    if (!kindMatches) {
+        std::cerr << "[JWT] Токен не является " << Traits::typ << std::endl;
+        return false;
+    }
+
+    if (!claims.sub.present || !claims.hasExp) return false;
+    outSubject.assign(claims.sub.data, claims.sub.size);
+    outExpiresAt = claims.exp;
+
+    if (static_cast<uint64_t>(std::time(nullptr)) > outExpiresAt) {
+        std::cerr << "[JWT] " << Traits::name << " токен просрочен" << std::endl;
+        return false;
+    }
+
+    if constexpr (Kind == TokenKind::Access) {
+        TokenCache::put(token, outSubject, outExpiresAt);
+    }
+
+    return true;
+}
+
+template class TokenCodec<TokenKind::Access, SignatureAlgorithm::RS256>;
+template class TokenCodec<TokenKind::Refresh, SignatureAlgorithm::RS256>;
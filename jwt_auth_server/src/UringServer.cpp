@@ -0,0 +1,997 @@
+#include "../include/UringServer.h"
+#include "../include/EpollServer.h"
+#include "../include/HttpProtocol.h"
+#include "../include/HashExecutor.h"
+#include "../include/extern/httplib.h"
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const unsigned RING_ENTRIES = 1024;        ///< Размер SQ; CQ в 4 раза больше (multishot).
+    const unsigned BUFFER_COUNT = 1024;        ///< Буферов в provided buffer ring (степень двойки).
+    const unsigned BUFFER_SIZE = 4096;         ///< Размер одного буфера приёма.
+    const uint16_t BUFFER_GROUP = 0;           ///< Группа буферов для recv.
+    const size_t MAX_BUFFERED_SLACK = 65536;   ///< Сколько сверх payloadMaxBytes можно накопить в `in`.
+
+    /**
+     * @brief Вид операции в старших битах user_data; младшие 56 бит — id соединения.
+     */
+    enum Op : uint64_t {
+        OP_ACCEPT = 1,
+        OP_RECV,
+        OP_SEND,
+        OP_SHUTDOWN,
+        OP_CLOSE,
+        OP_WAKE,
+        OP_PROVIDE,
+        OP_CANCEL
+    };
+
+    /**
+     * @brief Как буферы приёма возвращаются ядру.
+     */
+    enum class BufferMode {
+        Ring,      ///< Provided buffer ring (IORING_REGISTER_PBUF_RING): возврат — запись в общую память.
+        Legacy     ///< IORING_OP_PROVIDE_BUFFERS: возврат — отдельная SQE.
+    };
+
+    const uint64_t ID_MASK = (uint64_t(1) << 56) - 1;
+
+    uint64_t tag(Op op, uint64_t id) { return (static_cast<uint64_t>(op) << 56) | id; }
+
+    int sysSetup(unsigned entries, io_uring_params* params) {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg, size_t argSize) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+    }
+
+    int sysRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+        return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+    }
+
+    /**
+     * @brief Кольца SQ/CQ одного io_uring и буферы приёма для recv.
+     *
+     * Используется только потоком своего цикла.
+     */
+    class Ring {
+    public:
+        ~Ring() {
+            if (ringFd >= 0) ::close(ringFd);
+            if (cqPtr && cqPtr != sqPtr) ::munmap(cqPtr, cqSize);
+            if (sqPtr) ::munmap(sqPtr, sqSize);
+            if (sqes) ::munmap(sqes, sqesSize);
+            if (bufRing) ::munmap(bufRing, bufRingSize);
+            if (buffers) ::munmap(buffers, static_cast<size_t>(BUFFER_COUNT) * BUFFER_SIZE);
+        }
+
+        /**
+         * @brief Создаёт кольцо и буферы приёма.
+         *
+         * Кольцо цикла (singleIssuer) создаётся выключенным (R_DISABLED) с SINGLE_ISSUER/DEFER_TASKRUN:
+         * подавать заявки будет только поток цикла, который включит его через enable().
+         * На ядрах без этих флагов создаётся обычное кольцо.
+         */
+        bool init(BufferMode bufferMode, bool singleIssuer, std::string& error) {
+            mode = bufferMode;
+            io_uring_params params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            if (singleIssuer)
+                params.flags |= IORING_SETUP_SUBMIT_ALL | IORING_SETUP_R_DISABLED |
+                                IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+            params.cq_entries = RING_ENTRIES * 4;
+            ringFd = sysSetup(RING_ENTRIES, &params);
+            if (ringFd < 0 && errno == EINVAL && singleIssuer) {
+                params = io_uring_params{};
+                params.flags = IORING_SETUP_CQSIZE;
+                params.cq_entries = RING_ENTRIES * 4;
+                ringFd = sysSetup(RING_ENTRIES, &params);
+            }
+            if (ringFd < 0) return failed("io_uring_setup", error);
+            disabled = (params.flags & IORING_SETUP_R_DISABLED) != 0;
+
+            if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP)) {
+                error = "ядро без IORING_FEAT_EXT_ARG/NODROP";
+                return false;
+            }
+
+            sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) sqSize = cqSize = std::max(sqSize, cqSize);
+
+            sqPtr = mapRing(sqSize, IORING_OFF_SQ_RING);
+            if (!sqPtr) return failed("mmap SQ", error);
+            cqPtr = single ? sqPtr : mapRing(cqSize, IORING_OFF_CQ_RING);
+            if (!cqPtr) return failed("mmap CQ", error);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mapRing(sqesSize, IORING_OFF_SQES));
+            if (!sqes) return failed("mmap SQE", error);
+
+            char* sq = static_cast<char*>(sqPtr);
+            sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqEntries = params.sq_entries;
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            localTail = *sqTail;
+
+            char* cq = static_cast<char*>(cqPtr);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            return registerBuffers(error);
+        }
+
+        /**
+         * @brief Включает кольцо, созданное с R_DISABLED; вызывается потоком цикла.
+         *
+         * В режиме Legacy здесь же отдаёт ядру все буферы приёма.
+         */
+        bool enable() {
+            if (disabled && sysRegister(ringFd, IORING_REGISTER_ENABLE_RINGS, nullptr, 0) != 0) return false;
+            disabled = false;
+
+            if (mode == BufferMode::Legacy) {
+                io_uring_sqe* entry = sqe();
+                if (!entry) return false;
+                entry->opcode = IORING_OP_PROVIDE_BUFFERS;
+                entry->fd = static_cast<int>(BUFFER_COUNT);
+                entry->addr = reinterpret_cast<uint64_t>(buffers);
+                entry->len = BUFFER_SIZE;
+                entry->off = 0;
+                entry->buf_group = BUFFER_GROUP;
+                entry->user_data = tag(OP_PROVIDE, 0);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Проверяет, что ядро действительно выдаёт буферы из buffer ring.
+         *
+         * Регистрация может пройти успешно, а recv всё равно получить -ENOBUFS
+         * (так ведут себя некоторые сборки ядра), поэтому проверяется один настоящий recv
+         * через socketpair.
+         */
+        bool bufferRingDelivers() {
+            int fds[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) return false;
+            char byte = 'x';
+            bool delivered = false;
+            if (::write(fds[1], &byte, 1) == 1) {
+                io_uring_sqe* entry = sqe();
+                if (entry) {
+                    entry->opcode = IORING_OP_RECV;
+                    entry->fd = fds[0];
+                    entry->flags = IOSQE_BUFFER_SELECT;
+                    entry->buf_group = BUFFER_GROUP;
+                    entry->user_data = tag(OP_RECV, 0);
+                    submitAndWait(1, 1000);
+                    drain([&delivered](const io_uring_cqe& cqe) {
+                        delivered = cqe.res == 1 && (cqe.flags & IORING_CQE_F_BUFFER);
+                    });
+                }
+            }
+            ::close(fds[0]);
+            ::close(fds[1]);
+            return delivered;
+        }
+
+        /**
+         * @brief Следующая свободная SQE (обнулённая); при заполненной SQ сначала отправляет накопленное.
+         */
+        io_uring_sqe* sqe() {
+            if (!reserve(1)) return nullptr;
+            unsigned index = localTail & sqMask;
+            io_uring_sqe* entry = &sqes[index];
+            std::memset(entry, 0, sizeof(*entry));
+            sqArray[index] = index;
+            localTail++;
+            return entry;
+        }
+
+        /**
+         * @brief Гарантирует n свободных SQE подряд (для связанных цепочек).
+         */
+        bool reserve(unsigned n) {
+            if (localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) + n <= sqEntries) return true;
+            submitAndWait(0, 0);
+            return localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) + n <= sqEntries;
+        }
+
+        /**
+         * @brief Отправляет накопленные SQE и ждёт хотя бы waitNr завершений (не дольше timeoutMs).
+         */
+        void submitAndWait(unsigned waitNr, long timeoutMs) {
+            __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+            unsigned toSubmit = localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+
+            __kernel_timespec ts{};
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = (timeoutMs % 1000) * 1000000;
+            io_uring_getevents_arg arg{};
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+            unsigned flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+            int result = sysEnter(ringFd, toSubmit, waitNr, flags, &arg, sizeof(arg));
+            if (result < 0 && errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+                std::cerr << "[UringServer] io_uring_enter: " << std::strerror(errno) << std::endl;
+        }
+
+        /**
+         * @brief Передаёт все готовые CQE обработчику и освобождает их.
+         */
+        template <typename Handler>
+        void drain(Handler&& handler) {
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            while (head != tail) {
+                io_uring_cqe cqe = cqes[head & cqMask];
+                ++head;
+                __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+                handler(cqe);
+                if (head == tail) tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            }
+        }
+
+        /**
+         * @brief Данные буфера, выбранного ядром для recv.
+         */
+        const char* buffer(uint16_t bid) const {
+            return static_cast<const char*>(buffers) + static_cast<size_t>(bid) * BUFFER_SIZE;
+        }
+
+        /**
+         * @brief Возвращает буфер ядру.
+         */
+        void recycle(uint16_t bid) {
+            if (mode == BufferMode::Legacy) {
+                io_uring_sqe* entry = sqe();
+                if (!entry) return;
+                entry->opcode = IORING_OP_PROVIDE_BUFFERS;
+                entry->fd = 1;
+                entry->addr = reinterpret_cast<uint64_t>(buffer(bid));
+                entry->len = BUFFER_SIZE;
+                entry->off = bid;
+                entry->buf_group = BUFFER_GROUP;
+                entry->flags = IOSQE_CQE_SKIP_SUCCESS;
+                entry->user_data = tag(OP_PROVIDE, 0);
+                return;
+            }
+            io_uring_buf* buf = &bufRing->bufs[bufTail & (BUFFER_COUNT - 1)];
+            buf->addr = reinterpret_cast<uint64_t>(buffer(bid));
+            buf->len = BUFFER_SIZE;
+            buf->bid = bid;
+            ++bufTail;
+            __atomic_store_n(&bufRing->tail, bufTail, __ATOMIC_RELEASE);
+        }
+
+    private:
+        int ringFd = -1;
+        bool disabled = false;
+        BufferMode mode = BufferMode::Ring;
+
+        void* sqPtr = nullptr;
+        size_t sqSize = 0;
+        void* cqPtr = nullptr;
+        size_t cqSize = 0;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqesSize = 0;
+
+        unsigned* sqHead = nullptr;
+        unsigned* sqTail = nullptr;
+        unsigned* sqArray = nullptr;
+        unsigned sqMask = 0;
+        unsigned sqEntries = 0;
+        unsigned localTail = 0;      ///< Хвост SQ с ещё не опубликованными SQE.
+
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        io_uring_buf_ring* bufRing = nullptr;
+        size_t bufRingSize = 0;
+        void* buffers = nullptr;
+        uint16_t bufTail = 0;
+
+        static bool failed(const char* what, std::string& error) {
+            error = std::string(what) + ": " + std::strerror(errno);
+            return false;
+        }
+
+        void* mapRing(size_t size, off_t offset) {
+            void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+            return ptr == MAP_FAILED ? nullptr : ptr;
+        }
+
+        bool registerBuffers(std::string& error) {
+            size_t bytes = static_cast<size_t>(BUFFER_COUNT) * BUFFER_SIZE;
+            void* area = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (area == MAP_FAILED) return failed("mmap buffers", error);
+            buffers = area;
+            if (mode == BufferMode::Legacy) return true;   // буферы отдаются в enable()
+
+            bufRingSize = BUFFER_COUNT * sizeof(io_uring_buf);
+            void* ring = ::mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ring == MAP_FAILED) return failed("mmap buffer ring", error);
+            bufRing = static_cast<io_uring_buf_ring*>(ring);
+
+            io_uring_buf_reg reg{};
+            reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+            reg.ring_entries = BUFFER_COUNT;
+            reg.bgid = BUFFER_GROUP;
+            if (sysRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+                return failed("IORING_REGISTER_PBUF_RING", error);
+
+            for (unsigned bid = 0; bid < BUFFER_COUNT; ++bid) recycle(static_cast<uint16_t>(bid));
+            return true;
+        }
+    };
+
+    /**
+     * @brief Клиентское соединение; принадлежит одному циклу.
+     */
+    struct Connection {
+        enum class State {
+            Open,       ///< Обычная работа.
+            Draining,   ///< Отправлена цепочка send → shutdown → close, ждём её CQE.
+            Closed      ///< Сокет закрыт, ждём CQE отправки, читающей inflight.
+        };
+
+        int fd = -1;
+        State state = State::Open;
+        HttpSession session;
+        std::string inflight;            ///< Отправляемые сейчас байты (ядро читает их асинхронно).
+        size_t inflightOffset = 0;
+        bool sending = false;            ///< В кольце есть send этого соединения.
+        bool recvArmed = false;          ///< В кольце стоит multishot recv.
+        Clock::time_point lastActive;
+    };
+
+    /**
+     * @brief Ответ, подготовленный в пуле и возвращаемый в цикл.
+     */
+    struct Completion {
+        uint64_t id;
+        std::string response;
+        bool close;
+    };
+
+    std::atomic<bool> stop_requested{false};
+    std::atomic<bool> drain_requested{false};
+    std::atomic<int> drain_timeout_sec{0};
+
+    class UringLoop;
+    std::mutex loops_mutex;
+    std::vector<UringLoop*> active_loops;
+
+    /**
+     * @brief Цикл одного ядра: своё кольцо, слушающий сокет и соединения.
+     */
+    class UringLoop {
+    public:
+        UringLoop(size_t index, const HttpSettings& settings, httplib::ThreadPool& pool)
+            : index(index), settings(settings), pool(pool) {}
+
+        ~UringLoop() {
+            for (auto& entry : connections)
+                if (entry.second->fd >= 0) ::close(entry.second->fd);
+            if (listenFd >= 0) ::close(listenFd);
+            if (wakeFd >= 0) ::close(wakeFd);
+        }
+
+        /**
+         * @brief Создаёт кольцо и буферы приёма.
+         */
+        bool initRing(BufferMode mode, std::string& error) {
+            return ring.init(mode, true, error);
+        }
+
+        /**
+         * @brief Открывает слушающий сокет (SO_REUSEPORT) и eventfd.
+         */
+        bool open(const addrinfo* addr) {
+            // Сокеты блокирующие: ожиданием готовности занимается io_uring.
+            listenFd = HttpProtocol::listenReusePort(addr, settings.listenBacklog, false);
+            if (listenFd < 0) return false;
+            wakeFd = ::eventfd(0, EFD_CLOEXEC);
+            if (wakeFd < 0) {
+                std::cerr << "[UringServer] Цикл #" << index << ": eventfd: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        void run() {
+            if (!ring.enable()) {
+                std::cerr << "[UringServer] Цикл #" << index << ": не удалось включить кольцо: "
+                          << std::strerror(errno) << std::endl;
+                return;
+            }
+            int cpu = HttpProtocol::pinToCore(index);
+            if (cpu >= 0) std::cout << "[UringServer] Цикл #" << index << " закреплён за CPU " << cpu << std::endl;
+
+            armAccept();
+            armWake();
+
+            Clock::time_point lastSweep = Clock::now();
+            while (!stop_requested) {
+                if (drain_requested && !draining) beginDrain();
+
+                ring.submitAndWait(1, draining ? 100 : 1000);
+                ring.drain([this](const io_uring_cqe& cqe) { dispatch(cqe); });
+
+                Clock::time_point now = Clock::now();
+                if (draining) {
+                    closeDrained();
+                    if (listenFd < 0 && connections.empty()) break;
+                    if (now >= drainDeadline) {
+                        std::cerr << "[UringServer] Цикл #" << index << ": срок остановки истёк, обрываю соединений: "
+                                  << connections.size() << std::endl;
+                        break;
+                    }
+                }
+                if (now - lastSweep >= std::chrono::seconds(1)) {
+                    closeIdle(now);
+                    lastSweep = now;
+                }
+            }
+        }
+
+        /**
+         * @brief Передаёт ответ из пула в цикл (потокобезопасно).
+         */
+        void complete(Completion completion) {
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back(std::move(completion));
+            }
+            wake();
+        }
+
+        void wake() {
+            uint64_t one = 1;
+            ssize_t written = ::write(wakeFd, &one, sizeof(one));
+            (void)written;
+        }
+
+    private:
+        size_t index;
+        const HttpSettings& settings;
+        httplib::ThreadPool& pool;
+
+        Ring ring;
+        int listenFd = -1;
+        int wakeFd = -1;
+        uint64_t wakeValue = 0;          ///< Буфер чтения eventfd.
+        uint64_t nextId = 1;
+        std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections;
+        bool draining = false;
+        Clock::time_point drainDeadline;
+
+        std::mutex completedMutex;
+        std::vector<Completion> completed;
+
+        void armAccept() {
+            io_uring_sqe* sqe = ring.sqe();
+            if (!sqe) return;
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = listenFd;
+            sqe->accept_flags = SOCK_CLOEXEC;
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->user_data = tag(OP_ACCEPT, 0);
+        }
+
+        void armWake() {
+            io_uring_sqe* sqe = ring.sqe();
+            if (!sqe) return;
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = wakeFd;
+            sqe->addr = reinterpret_cast<uint64_t>(&wakeValue);
+            sqe->len = sizeof(wakeValue);
+            sqe->user_data = tag(OP_WAKE, 0);
+        }
+
+        void armRecv(Connection& conn) {
+            io_uring_sqe* sqe = ring.sqe();
+            if (!sqe) {
+                closeConnection(conn);
+                return;
+            }
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = conn.fd;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = BUFFER_GROUP;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->user_data = tag(OP_RECV, conn.session.id);
+            conn.recvArmed = true;
+        }
+
+        void dispatch(const io_uring_cqe& cqe) {
+            Op op = static_cast<Op>(cqe.user_data >> 56);
+            uint64_t id = cqe.user_data & ID_MASK;
+
+            switch (op) {
+                case OP_ACCEPT:
+                    if (cqe.res >= 0) onAccept(cqe.res);
+                    else if (cqe.res != -ECANCELED) logError("accept", -cqe.res);
+                    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                        if (draining) closeListener();
+                        else if (!stop_requested) armAccept();
+                    }
+                    break;
+                case OP_WAKE:
+                    processCompletions();
+                    if (!stop_requested) armWake();
+                    break;
+                case OP_RECV:
+                    onRecv(id, cqe);
+                    break;
+                case OP_SEND:
+                    onSend(id, cqe.res);
+                    break;
+                case OP_CLOSE:
+                    onClosed(id, cqe.res);
+                    break;
+                case OP_PROVIDE:
+                    if (cqe.res < 0) logError("provide buffers", -cqe.res);
+                    break;
+                case OP_SHUTDOWN:
+                case OP_CANCEL:
+                    break;
+            }
+        }
+
+        void logError(const char* what, int error) {
+            std::cerr << "[UringServer] Цикл #" << index << ": " << what << ": " << std::strerror(error) << std::endl;
+        }
+
+        Connection* find(uint64_t id) {
+            auto it = connections.find(id);
+            return it == connections.end() ? nullptr : it->second.get();
+        }
+
+        void onAccept(int fd) {
+            if (fd < 0) return;
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            auto conn = std::make_unique<Connection>();
+            conn->fd = fd;
+            conn->session.id = nextId++;
+            conn->session.draining = draining;
+            conn->lastActive = Clock::now();
+
+            sockaddr_storage addr{};
+            socklen_t len = sizeof(addr);
+            if (::getpeername(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+                char host[INET6_ADDRSTRLEN] = {};
+                if (addr.ss_family == AF_INET) {
+                    auto* in = reinterpret_cast<sockaddr_in*>(&addr);
+                    ::inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+                    conn->session.remotePort = ntohs(in->sin_port);
+                } else if (addr.ss_family == AF_INET6) {
+                    auto* in6 = reinterpret_cast<sockaddr_in6*>(&addr);
+                    ::inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+                    conn->session.remotePort = ntohs(in6->sin6_port);
+                }
+                conn->session.remoteAddr = host;
+            }
+
+            Connection& ref = *conn;
+            connections.emplace(ref.session.id, std::move(conn));
+            armRecv(ref);
+        }
+
+        void onRecv(uint64_t id, const io_uring_cqe& cqe) {
+            Connection* conn = find(id);
+            bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                if (conn && conn->state == Connection::State::Open && cqe.res > 0 && !conn->session.closeAfterWrite)
+                    conn->session.in.append(ring.buffer(bid), static_cast<size_t>(cqe.res));
+                ring.recycle(bid);
+            }
+            if (!conn || conn->state != Connection::State::Open) return;
+            if (!more) conn->recvArmed = false;
+
+            if (cqe.res > 0) {
+                conn->lastActive = Clock::now();
+                // Пока запрос выполняется в пуле, следующие копятся в `in`; без предела клиент мог бы раздуть буфер.
+                if (conn->session.in.size() > settings.payloadMaxBytes + MAX_BUFFERED_SLACK) {
+                    closeConnection(*conn);
+                    return;
+                }
+                if (!conn->recvArmed) armRecv(*conn);
+                processInput(*conn);
+            } else if (cqe.res == 0) {
+                conn->session.peerClosed = true;
+                processInput(*conn);
+            } else if (cqe.res == -ENOBUFS) {
+                // Все буферы заняты: они возвращаются сразу после копирования, так что это временно.
+                if (!conn->recvArmed) armRecv(*conn);
+            } else {
+                closeConnection(*conn);
+            }
+        }
+
+        /**
+         * @brief Выполняет готовые запросы и отправляет ответы.
+         */
+        void processInput(Connection& conn) {
+            uint64_t id = conn.session.id;
+            HttpProtocol::process(conn.session, settings,
+                [this, id](const Route* route, std::shared_ptr<httplib::Request> request, const AuthContext& auth,
+                             bool keepAlive) {
+                    return pool.enqueue([this, route, request, auth, id, keepAlive] {
+                        std::string response;
+                        HttpProtocol::respond(*route, *request, auth, keepAlive, response);
+                        complete(Completion{id, std::move(response), !keepAlive});
+                    });
+                });
+            flush(conn);
+        }
+
+        void processCompletions() {
+            std::vector<Completion> ready;
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                ready.swap(completed);
+            }
+
+            for (Completion& completion : ready) {
+                Connection* conn = find(completion.id);
+                if (!conn || conn->state != Connection::State::Open) continue; // клиент уже ушёл
+
+                HttpProtocol::complete(conn->session, std::move(completion.response), completion.close);
+                conn->lastActive = Clock::now();
+                processInput(*conn);
+            }
+        }
+
+        /**
+         * @brief Ставит в кольцо отправку накопленных ответов (не больше одной на соединение).
+         *
+         * Если после этого ответа соединение закрывается, отправка связывается
+         * с shutdown и close в одну цепочку.
+         */
+        void flush(Connection& conn) {
+            if (conn.state != Connection::State::Open || conn.sending) return;
+            HttpSession& session = conn.session;
+
+            if (!session.hasOutput()) {
+                if (session.finished()) closeConnection(conn);
+                return;
+            }
+
+            conn.inflight.swap(session.out);
+            session.out.clear();
+            session.outOffset = 0;
+            conn.inflightOffset = 0;
+
+            if (!session.pending && (session.closeAfterWrite || session.peerClosed)) sendAndClose(conn);
+            else sendInflight(conn);
+        }
+
+        void sendInflight(Connection& conn) {
+            io_uring_sqe* sqe = ring.sqe();
+            if (!sqe) {
+                closeConnection(conn);
+                return;
+            }
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = conn.fd;
+            sqe->addr = reinterpret_cast<uint64_t>(conn.inflight.data() + conn.inflightOffset);
+            sqe->len = static_cast<uint32_t>(conn.inflight.size() - conn.inflightOffset);
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = tag(OP_SEND, conn.session.id);
+            conn.sending = true;
+        }
+
+        /**
+         * @brief Последний ответ: send → shutdown → close одной связанной цепочкой.
+         *
+         * MSG_WAITALL заставляет ядро дослать ответ целиком; короткая отправка
+         * обрывает цепочку, и close приходит с -ECANCELED — тогда сокет закрывается здесь.
+         * shutdown нужен, чтобы завершить multishot recv: он держит ссылку на сокет,
+         * и один close не отправил бы клиенту FIN.
+         */
+        void sendAndClose(Connection& conn) {
+            if (!ring.reserve(3)) {
+                closeConnection(conn);
+                return;
+            }
+            uint64_t id = conn.session.id;
+
+            io_uring_sqe* send = ring.sqe();
+            send->opcode = IORING_OP_SEND;
+            send->fd = conn.fd;
+            send->addr = reinterpret_cast<uint64_t>(conn.inflight.data());
+            send->len = static_cast<uint32_t>(conn.inflight.size());
+            send->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+            send->flags = IOSQE_IO_LINK | IOSQE_CQE_SKIP_SUCCESS;
+            send->user_data = tag(OP_SEND, id);
+
+            io_uring_sqe* shutdown = ring.sqe();
+            shutdown->opcode = IORING_OP_SHUTDOWN;
+            shutdown->fd = conn.fd;
+            shutdown->len = SHUT_RDWR;
+            shutdown->flags = IOSQE_IO_LINK | IOSQE_CQE_SKIP_SUCCESS;
+            shutdown->user_data = tag(OP_SHUTDOWN, id);
+
+            io_uring_sqe* close = ring.sqe();
+            close->opcode = IORING_OP_CLOSE;
+            close->fd = conn.fd;
+            close->user_data = tag(OP_CLOSE, id);
+
+            conn.state = Connection::State::Draining;
+        }
+
+        void onSend(uint64_t id, int res) {
+            Connection* conn = find(id);
+            if (!conn) return;
+
+            if (conn->state == Connection::State::Closed) {
+                connections.erase(id);
+                return;
+            }
+            if (conn->state == Connection::State::Draining) return; // исход цепочки придёт с CQE close
+
+            conn->sending = false;
+            if (res < 0) {
+                closeConnection(*conn);
+                return;
+            }
+            conn->lastActive = Clock::now();
+            conn->inflightOffset += static_cast<size_t>(res);
+            if (conn->inflightOffset < conn->inflight.size()) {
+                sendInflight(*conn);
+                return;
+            }
+            conn->inflight.clear();
+            conn->inflightOffset = 0;
+            flush(*conn);
+        }
+
+        void onClosed(uint64_t id, int res) {
+            Connection* conn = find(id);
+            if (!conn) return;
+            if (res < 0) {
+                // Цепочка оборвана (клиент ушёл раньше) — закрываем сами.
+                ::shutdown(conn->fd, SHUT_RDWR);
+                ::close(conn->fd);
+            }
+            connections.erase(id);
+        }
+
+        /**
+         * @brief Начало плавной остановки: отменяет multishot accept.
+         *
+         * Слушающий сокет закрывается, когда придёт последняя CQE accept (closeListener()).
+         */
+        void beginDrain() {
+            draining = true;
+            drainDeadline = Clock::now() + std::chrono::seconds(drain_timeout_sec.load());
+            for (auto& entry : connections) entry.second->session.draining = true;
+
+            io_uring_sqe* sqe = ring.sqe();
+            if (!sqe) {
+                closeListener();
+                return;
+            }
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = tag(OP_ACCEPT, 0);
+            sqe->user_data = tag(OP_CANCEL, 0);
+        }
+
+        /**
+         * @brief Принимает соединения, оставшиеся в очереди слушающего сокета, и закрывает его.
+         */
+        void closeListener() {
+            if (listenFd < 0) return;
+            int flags = ::fcntl(listenFd, F_GETFL);
+            if (flags >= 0 && ::fcntl(listenFd, F_SETFL, flags | O_NONBLOCK) == 0) {
+                int fd;
+                while ((fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) onAccept(fd);
+            }
+            ::close(listenFd);
+            listenFd = -1;
+            std::cout << "[UringServer] Цикл #" << index << ": приём остановлен, соединений: " << connections.size()
+                      << std::endl;
+        }
+
+        /**
+         * @brief Закрывает соединения, которым больше нечего отправлять (как в EpollServer).
+         *
+         * Соединение, ещё не приславшее ни одного запроса, ждёт его до срока остановки.
+         */
+        void closeDrained() {
+            std::vector<Connection*> idle;
+            for (auto& entry : connections) {
+                Connection& conn = *entry.second;
+                const HttpSession& session = conn.session;
+                if (conn.state == Connection::State::Open && !conn.sending && session.served && !session.pending &&
+                    !session.hasOutput() && session.in.empty())
+                    idle.push_back(&conn);
+            }
+            for (Connection* conn : idle) closeConnection(*conn);
+        }
+
+        /**
+         * @brief Закрывает сокет сразу (ошибка, таймаут).
+         *
+         * Если в кольце ещё стоит send, объект живёт до его CQE: ядро может читать inflight.
+         */
+        void closeConnection(Connection& conn) {
+            ::shutdown(conn.fd, SHUT_RDWR);
+            ::close(conn.fd);
+            conn.fd = -1;
+            if (conn.sending) {
+                conn.state = Connection::State::Closed;
+                return;
+            }
+            connections.erase(conn.session.id);
+        }
+
+        /**
+         * @brief Закрывает соединения, простаивающие дольше таймаута (как в EpollServer).
+         */
+        void closeIdle(Clock::time_point now) {
+            std::vector<Connection*> expired;
+            for (auto& entry : connections) {
+                Connection& conn = *entry.second;
+                if (conn.state != Connection::State::Open || conn.session.pending) continue;
+
+                int limit = (conn.sending || conn.session.hasOutput()) ? settings.writeTimeoutSec
+                          : !conn.session.in.empty()                  ? settings.readTimeoutSec
+                                                                       : settings.keepAliveTimeoutSec;
+                if (now - conn.lastActive > std::chrono::seconds(limit)) expired.push_back(&conn);
+            }
+            for (Connection* conn : expired) closeConnection(*conn);
+        }
+    };
+
+    /**
+     * @brief Ядро не ниже major.minor.
+     */
+    bool kernelAtLeast(int major, int minor) {
+        utsname info{};
+        if (::uname(&info) != 0) return false;
+        int kMajor = 0, kMinor = 0;
+        if (std::sscanf(info.release, "%d.%d", &kMajor, &kMinor) != 2) return false;
+        return kMajor > major || (kMajor == major && kMinor >= minor);
+    }
+}
+
+bool UringServer::run(const HttpSettings& settings) {
+    stop_requested = false;   // drain_requested не сбрасывается: drain() мог прийти до запуска
+
+    if (!kernelAtLeast(6, 0)) {
+        std::cerr << "[UringServer] Нужно ядро 6.0+ (multishot recv), запускаю EpollServer" << std::endl;
+        return EpollServer::run(settings);
+    }
+
+    std::string error;
+    BufferMode mode = BufferMode::Ring;
+    {
+        Ring probe;
+        if (!probe.init(BufferMode::Ring, false, error)) {
+            std::cerr << "[UringServer] io_uring недоступен (" << error << "), запускаю EpollServer" << std::endl;
+            return EpollServer::run(settings);
+        }
+        if (!probe.bufferRingDelivers()) {
+            mode = BufferMode::Legacy;
+            std::cout << "[UringServer] Buffer ring не выдаёт буферы на этом ядре, "
+                         "буферы приёма передаются через IORING_OP_PROVIDE_BUFFERS" << std::endl;
+        }
+    }
+
+    size_t loopCount = settings.eventLoops ? settings.eventLoops
+                                           : std::max(1u, std::thread::hardware_concurrency());
+    size_t baseWorkers = settings.workers ? settings.workers : CPPHTTPLIB_THREAD_POOL_COUNT;
+    size_t poolSize = baseWorkers + HashExecutor::capacity();
+    httplib::ThreadPool pool(poolSize, settings.maxQueuedRequests);
+
+    std::vector<std::unique_ptr<UringLoop>> loops;
+    for (size_t i = 0; i < loopCount; ++i) {
+        loops.push_back(std::make_unique<UringLoop>(i, settings, pool));
+        if (!loops.back()->initRing(mode, error)) {
+            std::cerr << "[UringServer] io_uring недоступен (" << error << "), запускаю EpollServer" << std::endl;
+            loops.clear();
+            pool.shutdown();
+            return EpollServer::run(settings);
+        }
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addr = nullptr;
+    std::string port = std::to_string(settings.port);
+    if (::getaddrinfo(settings.host.c_str(), port.c_str(), &hints, &addr) != 0 || !addr) {
+        std::cerr << "[UringServer] Не удалось разрешить адрес " << settings.host << std::endl;
+        pool.shutdown();
+        return false;
+    }
+    for (auto& loop : loops) {
+        if (!loop->open(addr)) {
+            std::cerr << "[UringServer] Не удалось занять " << settings.host << ":" << settings.port << std::endl;
+            ::freeaddrinfo(addr);
+            pool.shutdown();
+            return false;
+        }
+    }
+    ::freeaddrinfo(addr);
+
+    {
+        std::lock_guard<std::mutex> lock(loops_mutex);
+        for (auto& loop : loops) active_loops.push_back(loop.get());
+    }
+
+    std::cout << "[UringServer] Сервер запущен на " << settings.host << ":" << settings.port << ", колец "
+              << loopCount << " (по " << BUFFER_COUNT << " буферов приёма, "
+              << (mode == BufferMode::Ring ? "buffer ring" : "provide buffers") << "), пул для блокирующих маршрутов "
+              << poolSize << ", очередь до " << settings.maxQueuedRequests << std::endl;
+
+    std::vector<std::thread> threads;
+    for (auto& loop : loops)
+        threads.emplace_back(&UringLoop::run, loop.get());
+    for (auto& t : threads) t.join();
+
+    {
+        std::lock_guard<std::mutex> lock(loops_mutex);
+        active_loops.clear();
+    }
+
+    // Задачи пула ссылаются на циклы — дожидаемся их до разрушения циклов.
+    pool.shutdown();
+    std::cout << "[UringServer] Остановлен" << std::endl;
+    return true;
+}
+
+void UringServer::stop() {
+    stop_requested = true;
+    std::lock_guard<std::mutex> lock(loops_mutex);
+    for (UringLoop* loop : active_loops) loop->wake();
+}
+
+void UringServer::drain(std::chrono::seconds timeout) {
+    drain_timeout_sec = static_cast<int>(timeout.count());
+    drain_requested = true;
+    std::lock_guard<std::mutex> lock(loops_mutex);
+    for (UringLoop* loop : active_loops) loop->wake();
+}
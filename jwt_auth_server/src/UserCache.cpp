@@ -0,0 +1,165 @@
+#include "../include/UserCache.h"
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Простой LRU-список: голова — самая свежая запись.
+     */
+    template <typename Value>
+    struct Lru {
+        using Entry = std::pair<std::string, Value>;
+        std::list<Entry> order;
+        std::unordered_map<std::string, typename std::list<Entry>::iterator> index;
+
+        Value* find(const std::string& key) {
+            auto it = index.find(key);
+            if (it == index.end()) return nullptr;
+            order.splice(order.begin(), order, it->second);
+            return &it->second->second;
+        }
+
+        /// @return true, если пришлось вытеснить самую старую запись.
+        bool insert(const std::string& key, Value value, size_t capacity) {
+            auto it = index.find(key);
+            if (it != index.end()) {
+                it->second->second = std::move(value);
+                order.splice(order.begin(), order, it->second);
+                return false;
+            }
+            order.emplace_front(key, std::move(value));
+            index[key] = order.begin();
+            if (index.size() <= capacity) return false;
+            index.erase(order.back().first);
+            order.pop_back();
+            return true;
+        }
+
+        void erase(const std::string& key) {
+            auto it = index.find(key);
+            if (it == index.end()) return;
+            order.erase(it->second);
+            index.erase(it);
+        }
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        uint64_t generation = 0;
+        Lru<User> users;
+        Lru<Clock::time_point> missing; ///< Значение — момент истечения негативной записи.
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t capacity_per_shard = 0;
+    size_t negative_capacity_per_shard = 0;
+    Clock::duration negative_ttl = std::chrono::seconds(30);
+
+    std::atomic<uint64_t> stat_hits{0};
+    std::atomic<uint64_t> stat_negative_hits{0};
+    std::atomic<uint64_t> stat_misses{0};
+    std::atomic<uint64_t> stat_evictions{0};
+    std::atomic<uint64_t> stat_invalidations{0};
+
+    Shard* shardFor(const std::string& username) {
+        if (shards.empty() || capacity_per_shard == 0) return nullptr;
+        return shards[std::hash<std::string>{}(username) % shards.size()].get();
+    }
+
+    struct DefaultConfig {
+        DefaultConfig() { UserCache::configure(10000, 16, 10000, std::chrono::seconds(30)); }
+    } default_config;
+}
+
+void UserCache::configure(size_t capacity, size_t shardCount,
+                          size_t negativeCapacity, std::chrono::milliseconds negativeTtl) {
+    if (shardCount == 0) shardCount = 1;
+
+    shards.clear();
+    for (size_t i = 0; i < shardCount; ++i)
+        shards.push_back(std::make_unique<Shard>());
+
+    capacity_per_shard = (capacity + shardCount - 1) / shardCount;
+    negative_capacity_per_shard = (negativeCapacity + shardCount - 1) / shardCount;
+    negative_ttl = negativeTtl;
+}
+
+UserCache::Lookup UserCache::lookup(const std::string& username, User& user_out, uint64_t& generation) {
+    Shard* shard = shardFor(username);
+    if (!shard) {
+        stat_misses++;
+        return Lookup::Miss;
+    }
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    generation = shard->generation;
+
+    if (User* user = shard->users.find(username)) {
+        user_out = *user;
+        stat_hits++;
+        return Lookup::Hit;
+    }
+
+    if (Clock::time_point* expiresAt = shard->missing.find(username)) {
+        if (Clock::now() < *expiresAt) {
+            stat_negative_hits++;
+            return Lookup::KnownMissing;
+        }
+        shard->missing.erase(username);
+    }
+
+    stat_misses++;
+    return Lookup::Miss;
+}
+
+void UserCache::put(const User& user, uint64_t generation) {
+    Shard* shard = shardFor(user.username);
+    if (!shard) return;
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    if (shard->generation != generation) return;
+
+    shard->missing.erase(user.username);
+    if (shard->users.insert(user.username, user, capacity_per_shard))
+        stat_evictions++;
+}
+
+void UserCache::putMissing(const std::string& username, uint64_t generation) {
+    Shard* shard = shardFor(username);
+    if (!shard || negative_capacity_per_shard == 0) return;
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    if (shard->generation != generation) return;
+
+    if (shard->missing.insert(username, Clock::now() + negative_ttl, negative_capacity_per_shard))
+        stat_evictions++;
+}
+
+void UserCache::invalidate(const std::string& username) {
+    Shard* shard = shardFor(username);
+    if (!shard) return;
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->generation++;
+    shard->users.erase(username);
+    shard->missing.erase(username);
+    stat_invalidations++;
+}
+
+UserCacheStats UserCache::getStats() {
+    UserCacheStats stats;
+    stats.hits = stat_hits.load();
+    stats.negativeHits = stat_negative_hits.load();
+    stats.misses = stat_misses.load();
+    stats.evictions = stat_evictions.load();
+    stats.invalidations = stat_invalidations.load();
+    return stats;
+}
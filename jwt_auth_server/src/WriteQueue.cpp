@@ -0,0 +1,176 @@
+#include "../include/WriteQueue.h"
+#include "../include/Database.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Операция в очереди вместе с обещанием, которое завершится после фиксации.
+     */
+    struct PendingWrite {
+        WriteOp op;
+        std::promise<bool> done;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    std::thread writer;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<PendingWrite> pending;
+    bool running = false;
+    bool stop_requested = false;
+
+    size_t max_batch_size = 64;
+    std::chrono::microseconds max_delay(2000);
+
+    std::atomic<uint64_t> stat_enqueued{0};
+    std::atomic<uint64_t> stat_batches{0};
+    std::atomic<uint64_t> stat_failed{0};
+    std::atomic<uint64_t> stat_largest{0};
+    std::atomic<uint64_t> stat_commit_us{0};
+
+    void commitBatch(std::vector<PendingWrite>& batch) {
+        std::vector<WriteOp> ops;
+        ops.reserve(batch.size());
+        for (auto& w : batch) ops.push_back(std::move(w.op));
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<bool> results;
+        bool committed = Database::applyBatch(ops, results);
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        stat_batches++;
+        if (!committed) stat_failed++;
+        stat_commit_us += static_cast<uint64_t>(micros);
+        uint64_t prev = stat_largest.load();
+        while (batch.size() > prev && !stat_largest.compare_exchange_weak(prev, batch.size())) {}
+
+        for (size_t i = 0; i < batch.size(); ++i)
+            batch[i].done.set_value(results[i]);
+    }
+
+    void writerLoop() {
+        std::vector<PendingWrite> batch;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [] { return stop_requested || !pending.empty(); });
+                if (pending.empty()) return; // stop_requested и очередь пуста
+
+                // Даём пакету наполниться, пока не истечёт окно первой операции.
+                auto deadline = pending.front().enqueuedAt + max_delay;
+                queue_cv.wait_until(lock, deadline, [] {
+                    return stop_requested || pending.size() >= max_batch_size;
+                });
+
+                size_t n = std::min(pending.size(), max_batch_size);
+                for (size_t i = 0; i < n; ++i) {
+                    batch.push_back(std::move(pending.front()));
+                    pending.pop_front();
+                }
+            }
+
+            commitBatch(batch);
+            batch.clear();
+        }
+    }
+
+    std::future<bool> enqueue(WriteOp op) {
+        PendingWrite w;
+        w.op = std::move(op);
+        w.enqueuedAt = std::chrono::steady_clock::now();
+        std::future<bool> result = w.done.get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            // После stop() писатель может уже выйти на пустой очереди: операция не попала бы в пакет.
+            if (running && !stop_requested) {
+                pending.push_back(std::move(w));
+                stat_enqueued++;
+                if (pending.size() == 1 || pending.size() >= max_batch_size)
+                    queue_cv.notify_one();
+                return result;
+            }
+        }
+
+        // Очередь не запущена или останавливается — применяем операцию синхронно.
+        std::vector<PendingWrite> single;
+        single.push_back(std::move(w));
+        stat_enqueued++;
+        commitBatch(single);
+        return result;
+    }
+}
+
+void WriteQueue::start(size_t maxBatchSize, std::chrono::microseconds maxDelay) {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    if (running) return;
+
+    max_batch_size = maxBatchSize > 0 ? maxBatchSize : 1;
+    max_delay = maxDelay;
+    running = true;
+    stop_requested = false;
+
+    std::cout << "[WriteQueue] Запуск: пакет до " << max_batch_size
+              << " операций, окно " << max_delay.count() << " мкс" << std::endl;
+
+    writer = std::thread(writerLoop);
+}
+
+void WriteQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!running) return;
+        stop_requested = true;
+    }
+    queue_cv.notify_all();
+    if (writer.joinable()) writer.join();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        running = false;
+    }
+    std::cout << "[WriteQueue] Остановлена, очередь записана" << std::endl;
+}
+
+std::future<bool> WriteQueue::addUser(const std::string& username, const std::string& passwordHash) {
+    WriteOp op;
+    op.type = WriteOp::Type::InsertUser;
+    op.key = username;
+    op.value = passwordHash;
+    return enqueue(std::move(op));
+}
+
+std::future<bool> WriteQueue::updatePassword(const std::string& username, const std::string& passwordHash) {
+    WriteOp op;
+    op.type = WriteOp::Type::UpdatePassword;
+    op.key = username;
+    op.value = passwordHash;
+    return enqueue(std::move(op));
+}
+
+std::future<bool> WriteQueue::blacklistToken(const std::string& token, uint64_t expires_at) {
+    WriteOp op;
+    op.type = WriteOp::Type::BlacklistToken;
+    op.key = token;
+    op.expiresAt = expires_at;
+    return enqueue(std::move(op));
+}
+
+WriteQueueStats WriteQueue::getStats() {
+    WriteQueueStats stats;
+    stats.enqueued = stat_enqueued.load();
+    stats.batches = stat_batches.load();
+    stats.failedBatches = stat_failed.load();
+    stats.largestBatch = stat_largest.load();
+    stats.commitMicros = stat_commit_us.load();
+    return stats;
+}
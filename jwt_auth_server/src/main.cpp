@@ -1,9 +1,83 @@
 #include "../include/HttpServer.h"
 #include "../include/Database.h"
 #include "../include/KeyStorage.h"
+#include "../include/BlacklistCleaner.h"
+#include "../include/WriteQueue.h"
+#include "../include/PasswordEncryptor.h"
+#include "../include/HashExecutor.h"
+#include "../include/ServerConfig.h"
 
-int main() {
-    Database::init("users.db");
+#include <pthread.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Настраивает хеширование паролей.
+ *
+ * Если задано settings.passwordHashMs, стоимость калибруется под это время одного хеша.
+ */
+static void configurePasswordHashing(const ServerSettings& settings) {
+    PasswordHashParams params = PasswordEncryptor::currentParams();
+    params.algorithm = settings.passwordAlgorithm;
+    PasswordEncryptor::configure(params);
+
+    if (settings.passwordHashMs > 0 && params.algorithm != PasswordAlgorithm::LegacySHA256) {
+        PasswordEncryptor::configure(PasswordEncryptor::calibrate(params.algorithm,
+                                                                  std::chrono::milliseconds(settings.passwordHashMs)));
+    }
+}
+
+/**
+ * @brief Ждёт SIGTERM или SIGINT и плавно останавливает HTTP-сервер (HttpServer::shutdown()).
+ *
+ * Повторный сигнал завершает процесс сразу, не дожидаясь запросов.
+ */
+static void handleSignals(sigset_t signals, std::chrono::seconds drainTimeout) {
+    int signal = 0;
+    if (sigwait(&signals, &signal) != 0) return;
+    std::cout << "[main] Получен " << strsignal(signal) << ", останавливаю сервер (ожидание запросов до "
+              << drainTimeout.count() << " с)" << std::endl;
+    HttpServer::shutdown(drainTimeout);
+
+    if (sigwait(&signals, &signal) != 0) return;
+    std::cerr << "[main] Повторный " << strsignal(signal) << ", выход без ожидания запросов" << std::endl;
+    std::_Exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    if (ServerConfig::helpRequested(argc, argv)) {
+        ServerConfig::printUsage(argv[0]);
+        return 0;
+    }
+
+    ServerSettings settings;
+    if (!ServerConfig::load(argc, argv, settings)) {
+        std::cerr << "[main] Ошибка в настройках, запустите с --help для списка параметров\n";
+        return 1;
+    }
+    ServerConfig::print(settings);
+
+    // Сигналы блокируются до запуска потоков (маску наследуют все) и принимаются одним потоком.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::thread(handleSignals, signals, std::chrono::seconds(settings.http.shutdownTimeoutSec)).detach();
+
+    if (!Database::init(settings.storage)) {
+        std::cerr << "[main] Не удалось инициализировать хранилище\n";
+        return 1;
+    }
+
+    configurePasswordHashing(settings);
 
     RSAPublicKey pubKey;
     RSAPrivateKey privKey;
@@ -13,7 +87,22 @@ int main() {
         KeyStorage::saveKeys(pubKey, privKey);
     }
 
-    HttpServer::start(8080);
-    return 0;
-}
+    size_t hashThreads = settings.hashThreads ? settings.hashThreads
+                                              : std::max(1u, std::thread::hardware_concurrency() / 2);
+    size_t hashQueue = settings.hashQueue.value_or(hashThreads * 4);
+    HashExecutor::start(hashThreads, hashQueue);
+
+    WriteQueue::start(settings.writeBatchSize, std::chrono::microseconds(settings.writeBatchDelayUs));
+    BlacklistCleaner::start(std::chrono::seconds(settings.blacklistCleanupIntervalSec),
+                            settings.blacklistCleanupBatch);
 
+    int status = HttpServer::start(settings.http) ? 0 : 1;
+
+    // Фоновое перехеширование ставит записи в WriteQueue, поэтому HashExecutor останавливается раньше неё.
+    BlacklistCleaner::stop();
+    HashExecutor::stop();
+    WriteQueue::stop();
+    Database::close();
+    std::cout << "[main] Сервер остановлен" << std::endl;
+    return status;
+}
@@ -77,11 +77,17 @@ curl -s -w "\nStatus: %{http_code}\n" -X POST "$BASE_URL/refresh" \
      -d '{}'
 echo -e "\n------"
 
-echo -e "\n=== [11] Wait 65 seconds for access token to expire ==="
+echo -e "\n=== [11] Introspect access and revoked refresh tokens ==="
+curl -s -w "\nStatus: %{http_code}\n" -X POST "$BASE_URL/introspect" \
+     -H "Content-Type: application/json" \
+     -d "{\"tokens\":[\"$access_token\",\"$refresh_token\",\"invalid.token.value\"]}"
+echo -e "\n------"
+
+echo -e "\n=== [12] Wait 65 seconds for access token to expire ==="
 sleep 65
 echo -e "\n------"
 
-echo -e "\n=== [12] Access secure data with EXPIRED token ==="
+echo -e "\n=== [13] Access secure data with EXPIRED token ==="
 curl -s -w "\nStatus: %{http_code}\n" -X GET "$BASE_URL/secure/data" \
      -H "Authorization: Bearer $access_token"
 echo -e "\n------"
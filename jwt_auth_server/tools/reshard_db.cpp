@@ -0,0 +1,35 @@
+/**
+ * @file reshard_db.cpp
+ * @brief Офлайн-перешардирование SQLite-базы пользователей.
+ *
+ * Использование:
+ * ```
+ * jwt_reshard <исходная_база> <исходных_шардов> <новая_база> <новых_шардов>
+ * ```
+ * Например, перенос `users.db` на 4 шарда:
+ * ```
+ * jwt_reshard users.db 1 sharded/users.db 4
+ * ```
+ * создаст `sharded/users.shard0.db` … `sharded/users.shard3.db`.
+ * Сервер должен быть остановлен; исходные файлы не изменяются.
+ */
+#include "../include/SqliteStore.h"
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " <src_db> <src_shards> <dst_db> <dst_shards>\n";
+        return 2;
+    }
+
+    int srcShards = std::atoi(argv[2]);
+    int dstShards = std::atoi(argv[4]);
+    if (srcShards < 1 || dstShards < 1) {
+        std::cerr << "[reshard] Количество шардов должно быть положительным\n";
+        return 2;
+    }
+
+    return SqliteStore::reshard(argv[1], srcShards, argv[3], dstShards) ? 0 : 1;
+}